@@ -57,6 +57,15 @@ public:
      */
     Nanosecond phaseLoop(Args&&... args);
 
+    /**
+     * Run PhaseLoop configured with a Duration rather than a number of iterations, so
+     * the loop has to check the clock to know when it's done.
+     *
+     * @param args arguments forwarded to the workload being run.
+     * @return the CPU time this function took, in nanoseconds.
+     */
+    Nanosecond durationPhaseLoop(Args&&... args);
+
     /**
      *  Run native for-loop and record one timer metric per iteration.
      *
@@ -97,6 +106,8 @@ std::vector<Nanosecond> runTest(std::vector<std::string>& loopNames,
                 time = loops.simpleLoop(std::forward<Args>(args)...);
             } else if (loopName == "phase") {
                 time = loops.phaseLoop(std::forward<Args>(args)...);
+            } else if (loopName == "duration") {
+                time = loops.durationPhaseLoop(std::forward<Args>(args)...);
             } else if (loopName == "metrics") {
                 time = loops.metricsLoop(std::forward<Args>(args)...);
             } else if (loopName == "real") {
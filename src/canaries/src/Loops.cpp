@@ -88,6 +88,36 @@ Nanosecond Loops<Task, Args...>::phaseLoop(Args&&... args) {
     return after - before;
 }
 
+template <class Task, class... Args>
+Nanosecond Loops<Task, Args...>::durationPhaseLoop(Args&&... args) {
+
+    // The Duration is long enough that the loop is always ended by the iteration count
+    // below, but IterationChecker still has to keep an eye on the clock.
+    Orchestrator o{};
+    v1::ActorPhase<int> loop{
+        o,
+        std::make_unique<v1::IterationChecker>(std::make_optional(TimeSpec(std::chrono::hours{1})),
+                                               std::nullopt,
+                                               false,
+                                               0_ts,
+                                               0_ts,
+                                               std::nullopt),
+        1};
+    auto task = Task(std::forward<Args>(args)...);
+
+    int64_t i = 0;
+    int64_t before = now();
+    for (auto _ : loop) {
+        task.run();
+        if (++i == _iterations) {
+            break;
+        }
+    }
+    int64_t after = now();
+
+    return after - before;
+}
+
 template <class Task, class... Args>
 Nanosecond Loops<Task, Args...>::metricsLoop(Args&&... args) {
 
@@ -65,6 +65,8 @@ struct ProgramOptions {
         progDesc << R"(
     simple   Run native for-loop; used as the control group with no Genny code
     phase    Run just the PhaseLoop
+    duration Run just the PhaseLoop, bounded by a Duration rather than a number
+             of iterations; shows the cost of checking the clock
     metrics  Run native for-loop and record one timer metric per iteration
     real     Run PhaseLoop and record one timer metric per iteration; resembles
              how a real actor runs
@@ -128,7 +130,7 @@ struct ProgramOptions {
         if (vm.count("loop-type") >= 1)
             _loopNames = vm["loop-name"].as<std::vector<std::string>>();
         else
-            _loopNames = {"simple", "phase", "metrics", "real"};
+            _loopNames = {"simple", "phase", "duration", "metrics", "real"};
 
         _iterations = vm["iterations"].as<int64_t>();
         _mongoUri = vm["mongo-uri"].as<std::string>();
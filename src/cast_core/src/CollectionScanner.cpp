@@ -23,6 +23,7 @@
 #include <mongocxx/database.hpp>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/fiber/operations.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/throw_exception.hpp>
 
@@ -232,7 +233,7 @@ void CollectionScanner::run() {
         for (const auto&& _ : config) {
             if (config->skipFirstLoop) {
                 config->skipFirstLoop = false;
-                std::this_thread::sleep_for(std::chrono::seconds{1});
+                boost::this_fiber::sleep_for(std::chrono::seconds{1});
                 continue;
             }
             _runningActorCounter++;
@@ -275,7 +276,7 @@ void CollectionScanner::run() {
                         auto secs = sleepDuration.count() / (1000 * 1000 * 1000);
                         BOOST_LOG_TRIVIAL(info)
                             << "Scanner id: " << this->_index << " sleeping " << secs;
-                        std::this_thread::sleep_for(sleepDuration);
+                        boost::this_fiber::sleep_for(sleepDuration);
                     }
                 }
                 session.commit_transaction();
@@ -22,6 +22,7 @@
 #include <mongocxx/collection.hpp>
 
 #include <boost/log/trivial.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
 #include <boost/throw_exception.hpp>
 
 #include <bsoncxx/json.hpp>
@@ -31,6 +32,8 @@
 #include <gennylib/context.hpp>
 #include <gennylib/conventions.hpp>
 
+#include <value_generators/DocumentPipeline.hpp>
+
 using BsonView = bsoncxx::document::view;
 using CrudActor = genny::actor::CrudActor;
 
@@ -285,6 +288,188 @@ struct WriteOperation : public BaseOperation {
 using WriteOpCallback = std::function<std::unique_ptr<WriteOperation>(
     const Node&, bool, mongocxx::collection, metrics::Operation, PhaseContext&, ActorId)>;
 
+/**
+ * Documents an operation generates before the workload starts when its OperationCommand has
+ * `Pregenerate`, so generating them isn't part of what's measured:
+ *
+ *    OperationCommand:
+ *      Document: {a: {^RandomString: {length: 1000}}}
+ *      Pregenerate:
+ *        Count: 100000  # How many to generate.
+ *        Order: Random  # Or Cycle (the default) to use them in order.
+ *
+ * The documents are made once and shared by all of the Actor's threads.
+ */
+class Pregenerated {
+public:
+    /**
+     * @return nullopt if `opNode` doesn't have `Pregenerate`.
+     */
+    static std::optional<Pregenerated> maybe(const Node& opNode,
+                                             std::vector<DocumentGenerator>& generators,
+                                             PhaseContext& context,
+                                             ActorId id) {
+        auto& node = opNode["Pregenerate"];
+        if (!node) {
+            return std::nullopt;
+        }
+        const auto count = node["Count"].to<int64_t>();
+        if (count <= 0) {
+            BOOST_THROW_EXCEPTION(
+                InvalidConfigurationException("Pregenerate needs a positive Count."));
+        }
+        const auto order = node["Order"].maybe<std::string>().value_or("Cycle");
+        if (order != "Cycle" && order != "Random") {
+            BOOST_THROW_EXCEPTION(InvalidConfigurationException(
+                "Pregenerate Order must be Cycle or Random, not '" + order + "'."));
+        }
+        auto pool = context.actor().shared<const DocumentPool>(node, [&]() {
+            return std::make_shared<DocumentPool>(generators, size_t(count));
+        });
+        return Pregenerated{std::move(pool), order == "Random", context.rng(id)};
+    }
+
+    /**
+     * @return the first of the pool's `width()` documents to use next.
+     */
+    const bsoncxx::document::view* next() {
+        const auto i = _random ? _pick(*_rng) : _next++ % _pool->size();
+        return (*_pool)[i];
+    }
+
+    size_t width() const {
+        return _pool->width();
+    }
+
+private:
+    Pregenerated(std::shared_ptr<const DocumentPool> pool, bool random, DefaultRandom& rng)
+        : _pool{std::move(pool)},
+          _random{random},
+          _rng{&rng},
+          _pick{0, _pool->size() - 1},
+          // Threads start at different places so they don't all use the same documents.
+          _next{_pick(rng)} {}
+
+    std::shared_ptr<const DocumentPool> _pool;
+    bool _random;
+    // A pointer so std::optional<Pregenerated> can be assigned.
+    DefaultRandom* _rng;
+    boost::random::uniform_int_distribution<size_t> _pick;
+    size_t _next;
+};
+
+/**
+ * Documents an operation gets from generator threads when its OperationCommand has
+ * `Pipeline`, so the Actor's thread only has to send them:
+ *
+ *    OperationCommand:
+ *      Document: {a: {^RandomString: {length: 1000}}}
+ *      Pipeline:
+ *        Threads: 2  # Generator threads shared by all the Actor's threads. Default 1.
+ *        Depth: 64   # Documents each Actor thread can have waiting. Default 16.
+ *
+ * Each time no document was waiting, i.e. generation couldn't keep up, a
+ * `DocumentPipelineStall` operation of the Actor is recorded with how long it waited.
+ */
+class Pipelined {
+public:
+    /**
+     * @return nullopt if `opNode` doesn't have `Pipeline`.
+     */
+    static std::optional<Pipelined> maybe(const Node& opNode,
+                                          const std::vector<const Node*>& templates,
+                                          PhaseContext& context,
+                                          ActorId id) {
+        auto& node = opNode["Pipeline"];
+        if (!node) {
+            return std::nullopt;
+        }
+        if (opNode["Pregenerate"]) {
+            BOOST_THROW_EXCEPTION(
+                InvalidConfigurationException("Can't have both Pipeline and Pregenerate."));
+        }
+        const auto threads = node["Threads"].maybe<int64_t>().value_or(1);
+        const auto depth = node["Depth"].maybe<int64_t>().value_or(16);
+        if (threads <= 0 || depth <= 0) {
+            BOOST_THROW_EXCEPTION(
+                InvalidConfigurationException("Pipeline Threads and Depth must be positive."));
+        }
+        auto pipeline = context.actor().shared<DocumentPipeline>(
+            node, [&]() { return std::make_shared<DocumentPipeline>(size_t(threads)); });
+        // The generator threads can't share the Actor's RNG.
+        auto ring = std::make_shared<DocumentRing>(templates,
+                                                   context.rng(id).child(),
+                                                   id,
+                                                   size_t(depth),
+                                                   &context.actor().incCounter(id));
+        pipeline->add(ring);
+        return Pipelined{std::move(pipeline),
+                         std::move(ring),
+                         context.actor().operation("DocumentPipelineStall", id)};
+    }
+
+    /**
+     * Documents from `acquire()`. Their slot is given back to the ring when this goes
+     * away, even if sending them threw, so the ring can't run out of slots.
+     */
+    class Lease {
+    public:
+        Lease(DocumentRing& ring, const DocumentBatch& batch) : _ring{&ring}, _batch{&batch} {}
+
+        Lease(Lease&& other) noexcept
+            : _ring{std::exchange(other._ring, nullptr)}, _batch{other._batch} {}
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() {
+            if (_ring) {
+                _ring->release();
+            }
+        }
+
+        const DocumentBatch& operator*() const {
+            return *_batch;
+        }
+
+        const DocumentBatch* operator->() const {
+            return _batch;
+        }
+
+    private:
+        DocumentRing* _ring;
+        const DocumentBatch* _batch;
+    };
+
+    /**
+     * @return the next documents, valid while the Lease is.
+     */
+    Lease acquire() {
+        if (_ring->ready() > 0) {
+            return Lease{*_ring, _ring->acquire()};
+        }
+        const auto started = metrics::clock::now();
+        const auto& batch = _ring->acquire();
+        const auto finished = metrics::clock::now();
+        _stalls.report(finished,
+                       std::chrono::duration_cast<std::chrono::microseconds>(finished - started),
+                       metrics::OutcomeType::kSuccess);
+        return Lease{*_ring, batch};
+    }
+
+private:
+    Pipelined(std::shared_ptr<DocumentPipeline> pipeline,
+              std::shared_ptr<DocumentRing> ring,
+              metrics::Operation stalls)
+        : _pipeline{std::move(pipeline)}, _ring{std::move(ring)}, _stalls{stalls} {}
+
+    // Keeps the generator threads going while this uses the ring.
+    std::shared_ptr<DocumentPipeline> _pipeline;
+    std::shared_ptr<DocumentRing> _ring;
+    metrics::Operation _stalls;
+};
+
 // Not technically "crud" but it was easy to add and made
 // a few of the tests easier to write (by allowing inserts
 // to fail due to index constraint-violations.
@@ -337,31 +522,54 @@ struct InsertOneOperation : public WriteOperation {
           _collection{std::move(collection)},
           _operation{operation},
           _options{opNode["OperationOptions"].maybe<mongocxx::options::insert>().value_or(
-              mongocxx::options::insert{})},
-          _document{opNode["Document"].to<DocumentGenerator>(context, id)} {}
+              mongocxx::options::insert{})} {
+        _document.push_back(opNode["Document"].to<DocumentGenerator>(context, id));
+        _pregenerated = Pregenerated::maybe(opNode, _document, context, id);
+        _pipelined = Pipelined::maybe(opNode, {&opNode["Document"]}, context, id);
+    }
 
     mongocxx::model::write getModel() override {
-        auto document = _document();
+        if (_pregenerated) {
+            // The pool outlives the bulk write so it doesn't need a copy.
+            return mongocxx::model::insert_one{*_pregenerated->next()};
+        }
+        if (_pipelined) {
+            // The slot is given back before the bulk write is sent so the model needs a copy.
+            const auto lease = _pipelined->acquire();
+            return mongocxx::model::insert_one{bsoncxx::document::value{lease->views().front()}};
+        }
+        auto document = _document.front()();
         return mongocxx::model::insert_one{std::move(document)};
     }
 
     void run(mongocxx::client_session& session) override {
-        auto document = _document();
-        auto size = document.view().length();
+        std::optional<Pipelined::Lease> lease;
+        if (_pipelined) {
+            lease.emplace(_pipelined->acquire());
+        }
+        // Reuses _buffer so generating the document doesn't allocate.
+        auto document = _pregenerated ? *_pregenerated->next()
+            : lease                   ? (*lease)->views().front()
+                                      : _document.front().evaluateInto(_buffer);
+        auto size = document.length();
 
         this->doBlock(_operation, [&](metrics::OperationContext& ctx) {
-            (_onSession) ? _collection.insert_one(session, document.view(), _options)
-                         : _collection.insert_one(document.view(), _options);
+            (_onSession) ? _collection.insert_one(session, document, _options)
+                         : _collection.insert_one(document, _options);
             ctx.addDocuments(1);
             ctx.addBytes(size);
-            return std::make_optional(std::move(document));
+            return MaybeDoc{};
         });
     }
 
 private:
     bool _onSession;
     mongocxx::collection _collection;
-    DocumentGenerator _document;
+    // Just the one, but DocumentPool wants a vector.
+    std::vector<DocumentGenerator> _document;
+    DocumentBuffer _buffer;
+    std::optional<Pregenerated> _pregenerated;
+    std::optional<Pipelined> _pipelined;
     metrics::Operation _operation;
     mongocxx::options::insert _options;
 };
@@ -948,23 +1156,44 @@ struct InsertManyOperation : public BaseOperation {
             BOOST_THROW_EXCEPTION(InvalidConfigurationException(
                 "'insertMany' expects a 'Documents' field of sequence type."));
         }
+        std::vector<const Node*> templates;
         for (auto&& [k, document] : documents) {
             _docExprs.push_back(document.to<DocumentGenerator>(context, id));
+            templates.push_back(&document);
         }
+        _pregenerated = Pregenerated::maybe(opNode, _docExprs, context, id);
+        _pipelined = Pipelined::maybe(opNode, templates, context, id);
     }
 
     void run(mongocxx::client_session& session) override {
-        std::vector<bsoncxx::document::view_or_value> writeOps;
+        const bsoncxx::document::view* begin;
+        const bsoncxx::document::view* end;
         size_t bytes = 0;
-        for (auto&& docExpr : _docExprs) {
-            auto doc = docExpr();
-            bytes += doc.view().length();
-            writeOps.emplace_back(std::move(doc));
+        std::optional<Pipelined::Lease> lease;
+        if (_pregenerated) {
+            begin = _pregenerated->next();
+            end = begin + _pregenerated->width();
+            for (auto doc = begin; doc != end; ++doc) {
+                bytes += doc->length();
+            }
+        } else if (_pipelined) {
+            lease.emplace(_pipelined->acquire());
+            begin = (*lease)->views().data();
+            end = begin + (*lease)->size();
+            bytes = (*lease)->bytes();
+        } else {
+            _batch.clear();
+            for (auto&& docExpr : _docExprs) {
+                docExpr.generateBatch(1, _batch);
+            }
+            begin = _batch.views().data();
+            end = begin + _batch.size();
+            bytes = _batch.bytes();
         }
 
         this->doBlock(_operation, [&](metrics::OperationContext& ctx) {
-            auto result = (_onSession) ? _collection.insert_many(session, writeOps, _options)
-                                       : _collection.insert_many(writeOps, _options);
+            auto result = (_onSession) ? _collection.insert_many(session, begin, end, _options)
+                                       : _collection.insert_many(begin, end, _options);
 
             ctx.addBytes(bytes);
             if (result) {
@@ -980,6 +1209,9 @@ private:
     mongocxx::options::insert _options;
     metrics::Operation _operation;
     std::vector<DocumentGenerator> _docExprs;
+    DocumentBatch _batch;
+    std::optional<Pregenerated> _pregenerated;
+    std::optional<Pipelined> _pipelined;
 };
 
 /**
@@ -79,19 +79,17 @@ void genny::actor::Loader::run() {
                 uint remainingInserts = config->numDocuments;
                 {
                     auto totalOpCtx = _totalBulkLoad.start();
+                    // Reused by every batch so it only allocates for the first one.
+                    DocumentBatch batch;
                     while (remainingInserts > 0) {
                         // insert the next batch
                         int64_t numberToInsert =
                             std::min<int64_t>(config->batchSize, remainingInserts);
-                        auto docs = std::vector<bsoncxx::document::view_or_value>{};
-                        docs.reserve(remainingInserts);
-                        for (uint j = 0; j < numberToInsert; j++) {
-                            auto newDoc = config->documentExpr();
-                            docs.push_back(std::move(newDoc));
-                        }
+                        batch.clear();
+                        auto& docs = config->documentExpr.generateBatch(numberToInsert, batch);
                         {
                             auto individualOpCtx = _individualBulkLoad.start();
-                            auto result = collection.insert_many(std::move(docs));
+                            auto result = collection.insert_many(docs);
                             remainingInserts -= result->inserted_count();
                             individualOpCtx.success();
                         }
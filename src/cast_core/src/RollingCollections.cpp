@@ -22,6 +22,7 @@
 #include <mongocxx/database.hpp>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/fiber/operations.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/throw_exception.hpp>
 #include <gennylib/Cast.hpp>
@@ -404,7 +405,7 @@ struct OplogTailer : public RunOperation {
                 _idleLastReported = millis;
                 _idleCount = 0L;
             } else if (_idleCount % 100 == 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                boost::this_fiber::sleep_for(std::chrono::milliseconds(1));
             }
         } catch (mongocxx::operation_exception& e) {
             BOOST_LOG_TRIVIAL(error) << "Oplog tailer exception: " << e.what();
@@ -0,0 +1,70 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_5C0F3D7E_61B4_4C0B_9A0E_2D54E1B7C8A3_INCLUDED
+#define HEADER_5C0F3D7E_61B4_4C0B_9A0E_2D54E1B7C8A3_INCLUDED
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include <yaml-cpp/yaml.h>
+
+namespace genny::driver::v1 {
+
+/**
+ * A workload that has already been through WorkloadParser (external phase configs
+ * included and parameters replaced) saved in a binary form that loads without
+ * running the YAML parser.
+ *
+ * The file is a header, a table of every distinct string in the workload (keys,
+ * scalars and tags are each stored once) and the nodes in pre-order referring to
+ * strings by their index in the table.
+ *
+ * Compiled workloads are only meant to be read by the same genny build on the same
+ * kind of machine that wrote them: numbers are written in native byte order and
+ * files from a different format version are rejected.
+ *
+ * Written by `genny compile` and read by `genny run` (and the other subcommands)
+ * when given a file that starts with the right magic bytes.
+ */
+class CompiledWorkload {
+public:
+    /**
+     * Write a fully-parsed workload.
+     */
+    static void write(const YAML::Node& workload, std::ostream& out);
+
+    /**
+     * Rebuild the workload from the bytes `write()` wrote.
+     *
+     * @throws InvalidConfigurationException if the bytes aren't a compiled workload
+     *   of the current format version.
+     */
+    static YAML::Node read(std::string_view bytes);
+
+    /**
+     * Map a compiled workload file into memory and read it.
+     */
+    static YAML::Node load(const std::string& path);
+
+    /**
+     * @return whether `path` is a file starting with the compiled-workload magic bytes.
+     */
+    static bool isCompiled(const std::string& path);
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_5C0F3D7E_61B4_4C0B_9A0E_2D54E1B7C8A3_INCLUDED
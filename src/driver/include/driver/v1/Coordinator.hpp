@@ -0,0 +1,144 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_B2DB58EC_A2BF_49AE_9CBF_E831F2307D4B_INCLUDED
+#define HEADER_B2DB58EC_A2BF_49AE_9CBF_E831F2307D4B_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+#include <gennylib/Orchestrator.hpp>
+
+#include <driver/v1/DefaultDriver.hpp>
+
+namespace genny::driver::v1 {
+
+/**
+ * What a worker process has reported back by the end of the run.
+ */
+struct WorkerResult {
+    DefaultDriver::OutcomeCode outcome = DefaultDriver::OutcomeCode::kSuccess;
+    // The worker's metrics report in the format requested by the coordinator.
+    std::string report;
+};
+
+/**
+ * Runs a workload across several genny processes.
+ *
+ * The coordinator doesn't run any Actors itself. Each worker process connects to it
+ * and is sent its share of the workload: the `Threads` of every Actor (and Phase) are
+ * split between the workers and every `GlobalRate` is scaled down by the same share so
+ * the rate across all processes is the configured one.
+ *
+ * Before starting each Phase, a worker tells the coordinator it's ready and waits to be
+ * told to go, so Phases start at the same time in every process. Once its Actors are
+ * done the worker sends its metrics report back.
+ *
+ * Messages are framed as a `<kind> <number> <payload-size>` line followed by the payload.
+ * A peer announcing a payload over `kMaxPayloadSize` is disconnected.
+ */
+class Coordinator {
+public:
+    // Largest payload, i.e. workload share or metrics report, that's sent or accepted.
+    static constexpr size_t kMaxPayloadSize = size_t{1} << 30;
+
+    /**
+     * Starts listening immediately.
+     *
+     * @param address `host:port` to listen on. Port 0 picks any free port.
+     * @param processes how many workers to wait for.
+     */
+    Coordinator(const std::string& address, size_t processes);
+
+    /**
+     * @return the port being listened on.
+     */
+    uint16_t port() const;
+
+    /**
+     * Hand out the workload and keep the workers' Phases in step until they are all done.
+     *
+     * A worker that disconnects without reporting is treated as having failed and is no
+     * longer waited for.
+     *
+     * @param workload the fully-parsed workload.
+     * @param workloadName name to record the workers' own metrics under.
+     * @param metricsFormat format workers should report their metrics in.
+     * @return what each worker reported, in the order they connected.
+     */
+    std::vector<WorkerResult> run(const YAML::Node& workload,
+                                  const std::string& workloadName,
+                                  const std::string& metricsFormat);
+
+    /**
+     * The part of `workload` to run in worker `index` of `processes`.
+     *
+     * Leftover threads are spread round-robin starting at a different worker for each
+     * Actor so single-threaded Actors don't all end up in the first worker.
+     */
+    static YAML::Node shareOf(const YAML::Node& workload, size_t index, size_t processes);
+
+private:
+    const size_t _processes;
+    boost::asio::io_context _io;
+    boost::asio::ip::tcp::acceptor _acceptor;
+};
+
+/**
+ * A worker process's connection to its Coordinator.
+ */
+class CoordinatorClient {
+public:
+    /**
+     * @param address `host:port` of the coordinator.
+     */
+    explicit CoordinatorClient(const std::string& address);
+
+    struct Assignment {
+        size_t index;
+        size_t processes;
+        std::string workloadName;
+        std::string metricsFormat;
+        YAML::Node workload;
+    };
+
+    /**
+     * Block until the coordinator sends this worker its share of the workload.
+     */
+    Assignment awaitAssignment();
+
+    /**
+     * Block until every worker is ready to start `phase`.
+     */
+    void awaitPhaseStart(PhaseNumber phase);
+
+    /**
+     * Send the outcome and metrics report to the coordinator.
+     */
+    void finish(DefaultDriver::OutcomeCode outcome, const std::string& report);
+
+private:
+    boost::asio::io_context _io;
+    boost::asio::ip::tcp::socket _socket;
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_B2DB58EC_A2BF_49AE_9CBF_E831F2307D4B_INCLUDED
@@ -0,0 +1,97 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_B5A1D7E2_6C3F_4E09_9A4B_71F2C8D03E56_INCLUDED
+#define HEADER_B5A1D7E2_6C3F_4E09_9A4B_71F2C8D03E56_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace genny::driver::v1 {
+
+/**
+ * A CPU and the NUMA node it belongs to.
+ */
+struct CpuSlot {
+    int cpu;
+    int numaNode;
+
+    bool operator==(const CpuSlot& other) const {
+        return cpu == other.cpu && numaNode == other.numaNode;
+    }
+};
+
+/**
+ * The CPUs this process is allowed to run on, ordered by CPU number.
+ */
+using CpuTopology = std::vector<CpuSlot>;
+
+/**
+ * @return the CPUs in this process's affinity mask along with their NUMA nodes as
+ *         reported by sysfs. CPUs are all put on node 0 if sysfs has no NUMA information.
+ */
+CpuTopology discoverCpuTopology();
+
+/**
+ * Parse a Linux cpulist such as "0-3,8,10-11".
+ */
+std::vector<int> parseCpuList(const std::string& cpuList);
+
+/**
+ * Decides which CPU each Actor thread is pinned to. Configured by `--cpu-affinity`:
+ *
+ * - `none` (default): threads aren't pinned and the OS is free to migrate them.
+ * - `compact`: fill up one NUMA node before moving onto the next so actors
+ *   share caches and memory bandwidth.
+ * - `spread`: round-robin across NUMA nodes so actors get as much memory
+ *   bandwidth as possible.
+ * - a cpulist such as `0,2,4-7`: the i'th actor is pinned to the i'th CPU.
+ *
+ * Either way if there are more actors than CPUs the placement wraps around.
+ *
+ * With `--execution fibers` Actors move between worker threads, so the workers are placed
+ * instead of the Actors and the metrics output has a WorkerPlacement section in place of
+ * the per-Actor Placement one.
+ */
+class CpuAffinity {
+public:
+    enum class Policy { kNone, kCompact, kSpread, kExplicit };
+
+    explicit CpuAffinity(const std::string& spec);
+
+    Policy policy() const {
+        return _policy;
+    }
+
+    /**
+     * @param threads how many threads to place.
+     * @param topology the CPUs that can be used.
+     * @return the slot for each thread or an empty vector if threads shouldn't be pinned.
+     */
+    std::vector<CpuSlot> plan(size_t threads, const CpuTopology& topology) const;
+
+    /**
+     * Pin the calling thread to a single CPU.
+     */
+    static void pinCurrentThread(int cpu);
+
+private:
+    Policy _policy;
+    std::vector<int> _cpus;
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_B5A1D7E2_6C3F_4E09_9A4B_71F2C8D03E56_INCLUDED
@@ -15,6 +15,7 @@
 #ifndef HEADER_81A374DA_8E23_4E4D_96D2_619F27016F2A_INCLUDED
 #define HEADER_81A374DA_8E23_4E4D_96D2_619F27016F2A_INCLUDED
 
+#include <chrono>
 #include <optional>
 #include <string>
 #include <vector>
@@ -23,11 +24,12 @@
 
 #include <gennylib/ActorProducer.hpp>
 #include <gennylib/ActorVector.hpp>
+#include <gennylib/Orchestrator.hpp>
 
 namespace genny::driver {
 
 /**
- * Basic workload driver that spins up one thread per actor.
+ * Basic workload driver that spins up one thread (or fiber) per actor.
  */
 class DefaultDriver {
 public:
@@ -36,6 +38,11 @@ public:
         kDryRun,
         kEvaluate,
         kListActors,
+        kSaturate,
+        kSweep,
+        kCoordinate,
+        kWork,
+        kCompile,
         kHelp,
     };
 
@@ -63,11 +70,74 @@ public:
 
         std::string metricsFormat;
         std::string metricsOutputFileName;
+        // For the `compile` subcommand: where to write the compiled workload.
+        std::string compiledWorkloadFileName;
         std::string mongoUri;
         std::string description;
         bool isSmokeTest;
         DefaultDriver::RunMode runMode = RunMode::kNormal;
         boost::log::trivial::severity_level logVerbosity;
+
+        /**
+         * How actors are scheduled onto OS threads.
+         */
+        enum class Execution {
+            // One OS thread per actor.
+            kThreads,
+            // One fiber per actor, multiplexed over `workers` OS threads. Actors yield
+            // their worker while waiting on phase changes, rate limits and sleeps but
+            // still block it while waiting on the server.
+            kFibers,
+        };
+        Execution execution = Execution::kThreads;
+        // Number of OS threads to run fibers on. Zero means one per hardware thread.
+        size_t workers = 0;
+
+        // How to pin actor threads to CPUs, see driver::v1::CpuAffinity.
+        std::string cpuAffinity = "none";
+
+        // Number of threads to construct Actors on. Zero means one per hardware thread.
+        size_t setupThreads = 0;
+
+        // Record CPU performance counters for each actor thread, see
+        // driver::v1::PerfCounterSampler.
+        bool perfCounters = false;
+        // How often to record the performance counters.
+        std::chrono::milliseconds perfCountersWindow{1000};
+
+        // For the `coordinate` and `work` subcommands: `host:port` the coordinator listens on.
+        std::string coordinator;
+        // For the `coordinate` subcommand: how many worker processes to split the workload over.
+        size_t processes = 1;
+
+        /**
+         * Settings for the `saturate` subcommand.
+         */
+        struct SaturationOptions {
+            // Phase to run at increasing rates.
+            PhaseNumber phase = 0;
+            // Latency SLO e.g. "10 milliseconds".
+            std::string latency;
+            // Latency percentile the SLO applies to.
+            double percentile = 99;
+            // Bounds on the rate to search, in iterations per second.
+            int64_t minRate = 1;
+            int64_t maxRate = 100000;
+            // Upper bound on the number of times the phase is run.
+            int64_t maxTrials = 10;
+        };
+        SaturationOptions saturation;
+
+        /**
+         * Settings for the `sweep` subcommand.
+         */
+        struct SweepOptions {
+            // `Name=value1,value2,...` for each `^Parameter` to sweep.
+            std::vector<std::string> parameters;
+            // If set, only this phase is measured and the others only run for the first point.
+            std::optional<PhaseNumber> phase;
+        };
+        SweepOptions sweep;
     };
 
     /**
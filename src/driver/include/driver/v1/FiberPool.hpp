@@ -0,0 +1,54 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_054104D5_8487_41A2_8037_7A099C4613E7_INCLUDED
+#define HEADER_054104D5_8487_41A2_8037_7A099C4613E7_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace genny::driver::v1 {
+
+/**
+ * Default stack size for each fiber. Actors don't recurse deeply but the
+ * driver and logging code they call into can use a fair amount of stack.
+ */
+constexpr size_t kDefaultFiberStackSize = 256 * 1024;
+
+/**
+ * Run each task on its own fiber, with the fibers multiplexed over `workers`
+ * OS threads. Blocks until every task has finished.
+ *
+ * Fibers are suspended rather than blocking their worker thread when they
+ * wait on the Orchestrator or sleep in PhaseLoop, so many more tasks than
+ * workers can make progress. Blocking calls that aren't fiber-aware (e.g.
+ * network I/O in the driver) still block the whole worker thread.
+ *
+ * Idle workers take ready fibers from a shared queue so fibers can migrate
+ * between threads; tasks must not rely on thread-local state.
+ *
+ * @param tasks the tasks to run. Exceptions must not escape a task.
+ * @param workers number of OS threads to run the fibers on. Must be > 0.
+ * @param onWorkerStart if set, called on each worker thread with its index before it runs fibers.
+ * @param stackSize stack size for each fiber, in bytes.
+ */
+void runOnFibers(const std::vector<std::function<void()>>& tasks,
+                 size_t workers,
+                 const std::function<void(size_t)>& onWorkerStart = nullptr,
+                 size_t stackSize = kDefaultFiberStackSize);
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_054104D5_8487_41A2_8037_7A099C4613E7_INCLUDED
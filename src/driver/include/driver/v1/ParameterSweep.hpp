@@ -0,0 +1,114 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_A84C2E71_0B3F_4D6E_9F25_7E1C3D8B6A40_INCLUDED
+#define HEADER_A84C2E71_0B3F_4D6E_9F25_7E1C3D8B6A40_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include <driver/v1/DefaultDriver.hpp>
+#include <driver/workload_parsers.hpp>
+
+namespace genny::driver::v1 {
+
+/**
+ * The values of every swept `^Parameter` for one run of the workload.
+ */
+struct SweepPoint {
+    // (name, value) in the order the parameters were given.
+    std::vector<std::pair<std::string, std::string>> values;
+
+    /**
+     * @return the values in the form WorkloadParser takes them.
+     */
+    YamlParameters parameters() const;
+};
+
+/**
+ * What was measured while running the workload at one SweepPoint.
+ */
+struct SweepResult {
+    DefaultDriver::OutcomeCode outcome;
+    // PhaseLoop iterations completed.
+    int64_t iterations;
+    // Operations reported. An iteration may do several or, e.g. when stalled, report extra.
+    int64_t operations;
+    // How long the measured phase(s) took.
+    std::chrono::nanoseconds duration;
+    // Iterations per second.
+    double throughput;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p99;
+};
+
+/**
+ * Runs a workload once for every combination of values of some of its `^Parameter`s
+ * to get e.g. throughput as a function of Threads in a single genny invocation.
+ *
+ * Parameters are given as `Name=value1,value2,...`. With several parameters every
+ * combination is run, varying the last parameter fastest.
+ */
+class ParameterSweep {
+public:
+    /**
+     * @param specs one `Name=value1,value2,...` per parameter.
+     * @throws InvalidConfigurationException if a spec is malformed.
+     */
+    explicit ParameterSweep(const std::vector<std::string>& specs);
+
+    /**
+     * @return every point to run, in order.
+     */
+    const std::vector<SweepPoint>& points() const {
+        return _points;
+    }
+
+    /**
+     * @param read the `^Parameter` names the workload reads, see WorkloadParser::parameterNames().
+     * @throws InvalidConfigurationException if a swept parameter isn't one of them,
+     *   since every point would then run the same workload.
+     */
+    void checkParameters(const std::set<std::string>& read) const;
+
+    /**
+     * Record the outcome of running `points()[results().size()]`.
+     */
+    void record(const SweepResult& result);
+
+    const std::vector<SweepResult>& results() const {
+        return _results;
+    }
+
+    /**
+     * Write a csv row for every point run so far.
+     */
+    void report(std::ostream& out) const;
+
+private:
+    std::vector<std::string> _names;
+    std::vector<SweepPoint> _points;
+    std::vector<SweepResult> _results;
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_A84C2E71_0B3F_4D6E_9F25_7E1C3D8B6A40_INCLUDED
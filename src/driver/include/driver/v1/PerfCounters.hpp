@@ -0,0 +1,152 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_3E9B6F04_D1C7_4A52_8E3A_65C0B9F27D18_INCLUDED
+#define HEADER_3E9B6F04_D1C7_4A52_8E3A_65C0B9F27D18_INCLUDED
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <gennylib/Orchestrator.hpp>
+
+#include <metrics/metrics.hpp>
+
+namespace genny::driver::v1 {
+
+/**
+ * Totals of the counters opened by ThreadPerfCounters. Counters that couldn't be
+ * opened are empty.
+ */
+struct PerfReading {
+    std::optional<int64_t> cycles;
+    std::optional<int64_t> instructions;
+    std::optional<int64_t> cacheMisses;
+    std::optional<int64_t> contextSwitches;
+};
+
+/**
+ * Counts CPU cycles, instructions, cache misses and context switches of the thread that
+ * constructed it using perf_event_open(2).
+ *
+ * Opening a counter fails on machines or VMs without a PMU, in containers whose seccomp
+ * profile blocks perf_event_open and when `/proc/sys/kernel/perf_event_paranoid` doesn't
+ * allow it. Counters that fail to open are left out of every PerfReading and the reason
+ * is kept in `errors()`.
+ *
+ * The counters may be read from any thread.
+ */
+class ThreadPerfCounters {
+public:
+    ThreadPerfCounters();
+    ~ThreadPerfCounters();
+
+    ThreadPerfCounters(const ThreadPerfCounters&) = delete;
+    ThreadPerfCounters& operator=(const ThreadPerfCounters&) = delete;
+
+    /**
+     * @return whether at least one counter could be opened.
+     */
+    bool any() const;
+
+    /**
+     * @return counts since construction. Scaled up if the kernel had to multiplex the
+     *   hardware counters with other events.
+     */
+    PerfReading read() const;
+
+    /**
+     * @return counter name to why it couldn't be opened.
+     */
+    const std::map<std::string, std::string>& errors() const {
+        return _errors;
+    }
+
+private:
+    std::array<int, 4> _fds;
+    std::map<std::string, std::string> _errors;
+};
+
+/**
+ * Collects the ThreadPerfCounters of every Actor thread into the metrics Registry.
+ *
+ * Every `window` the counts since the previous window are recorded for each thread,
+ * as well as whenever a phase starts so each window belongs to a single phase.
+ */
+class PerfCounterSampler {
+public:
+    PerfCounterSampler(metrics::Registry& registry, std::chrono::milliseconds window);
+
+    /**
+     * Stops sampling. Threads still attached don't get a final window.
+     */
+    ~PerfCounterSampler();
+
+    PerfCounterSampler(const PerfCounterSampler&) = delete;
+    PerfCounterSampler& operator=(const PerfCounterSampler&) = delete;
+
+    /**
+     * Start counting for the calling thread. Logs a warning (once) if no counters
+     * could be opened and carries on without them.
+     */
+    void attachCurrentThread(ActorId actorId);
+
+    /**
+     * Record the last window for an Actor's thread and stop counting it.
+     */
+    void detach(ActorId actorId);
+
+    /**
+     * Record the windows up to now as part of the previous phase. Called from an
+     * Orchestrator pre-phase-start hook.
+     */
+    void phaseStarting(PhaseNumber phase);
+
+    /**
+     * Record a window for every attached thread.
+     */
+    void sample();
+
+private:
+    struct Attached {
+        std::unique_ptr<ThreadPerfCounters> counters;
+        PerfReading last;
+    };
+
+    // These expect _mutex to be held.
+    void sampleAll();
+    void record(ActorId actorId, Attached& attached, metrics::time_point now);
+
+    metrics::Registry& _registry;
+
+    std::mutex _mutex;
+    std::map<ActorId, Attached> _attached;
+    PhaseNumber _phase = 0;
+    bool _warned = false;
+
+    bool _stopping = false;
+    std::condition_variable _stop;
+    std::thread _sampler;
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_3E9B6F04_D1C7_4A52_8E3A_65C0B9F27D18_INCLUDED
@@ -0,0 +1,44 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_E3D4DA12_9D13_4A16_8EA6_7D1DDBA1087D_INCLUDED
+#define HEADER_E3D4DA12_9D13_4A16_8EA6_7D1DDBA1087D_INCLUDED
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace genny::driver::v1 {
+
+/**
+ * Combine the metrics reports of several genny processes into a single report
+ * as if all their Actors had run in one process.
+ *
+ * Works with both the "csv" and "cedar-csv" formats:
+ *
+ * - Timestamps are shifted onto the metrics clock of the first report using
+ *   each report's `Clocks` section, and that report's clocks are kept.
+ * - Actor ids (threads) are renumbered so ids from different processes don't collide.
+ * - `OperationThreadCounts` are added up and `Genny.ActiveActors` is recomputed
+ *   across all processes.
+ * - Everything else is concatenated in the order the reports are given.
+ *
+ * @param reports the reports to merge. Must not be empty.
+ * @param out where to write the merged report.
+ */
+void mergeReports(const std::vector<std::string>& reports, std::ostream& out);
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_E3D4DA12_9D13_4A16_8EA6_7D1DDBA1087D_INCLUDED
@@ -0,0 +1,120 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_7E0C5A2B_31D4_4F0A_8B6E_C2D9A4E51F37_INCLUDED
+#define HEADER_7E0C5A2B_31D4_4F0A_8B6E_C2D9A4E51F37_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include <gennylib/Orchestrator.hpp>
+
+namespace genny::driver::v1 {
+
+/**
+ * The outcome of running the search phase once at a fixed rate.
+ */
+struct SaturationTrial {
+    // Requested GlobalRate, in iterations per second.
+    int64_t rate;
+    // Achieved iterations per second.
+    double throughput;
+    // Observed latency at the configured percentile.
+    std::chrono::nanoseconds latency;
+    // If the trial sustained the rate without breaking the latency SLO.
+    bool meetsSlo;
+};
+
+/**
+ * Bisects over GlobalRate values to find the highest rate at which a phase
+ * still meets its latency SLO.
+ *
+ * The search is driven externally: ask for `nextRate()`, run the phase at
+ * that rate, and `record()` the outcome. The bounds are probed first so a
+ * workload that can't meet the SLO even at `minRate` (or that meets it at
+ * `maxRate`) finishes after one or two trials.
+ */
+class SaturationSearch {
+public:
+    /**
+     * @param minRate lowest rate (iterations per second) to consider.
+     * @param maxRate highest rate (iterations per second) to consider.
+     * @param maxTrials upper bound on the number of trials to run.
+     */
+    SaturationSearch(int64_t minRate, int64_t maxRate, int64_t maxTrials);
+
+    /**
+     * @return the rate to try next or `nullopt` if the search has converged.
+     */
+    std::optional<int64_t> nextRate() const;
+
+    /**
+     * Record the outcome of running at the rate previously given by `nextRate()`.
+     */
+    void record(const SaturationTrial& trial);
+
+    /**
+     * @return the highest rate known to meet the SLO, if any.
+     */
+    std::optional<int64_t> best() const {
+        return _highestPassing;
+    }
+
+    /**
+     * @return every trial recorded so far, in the order they were run.
+     */
+    const std::vector<SaturationTrial>& trajectory() const {
+        return _trajectory;
+    }
+
+    /**
+     * Write the trajectory and result as csv.
+     */
+    void report(std::ostream& out) const;
+
+    /**
+     * Derive the workload to run for a single trial.
+     *
+     * Every Actor's block for `phase` is throttled to `rate` iterations per second through
+     * a single shared rate-limiter. If `onlySearchPhase` is set, all other phases are made
+     * Nop by OnlyPhaseConverter so setup phases (e.g. loading data) aren't repeated on every
+     * trial.
+     *
+     * @param workload the fully-parsed workload. It is not modified.
+     * @return a copy of `workload` configured for the trial.
+     */
+    static YAML::Node configureTrial(const YAML::Node& workload,
+                                     PhaseNumber phase,
+                                     int64_t rate,
+                                     bool onlySearchPhase);
+
+private:
+    const int64_t _minRate;
+    const int64_t _maxRate;
+    const int64_t _maxTrials;
+
+    std::optional<int64_t> _highestPassing;
+    std::optional<int64_t> _lowestFailing;
+
+    std::vector<SaturationTrial> _trajectory;
+};
+
+}  // namespace genny::driver::v1
+
+#endif  // HEADER_7E0C5A2B_31D4_4F0A_8B6E_C2D9A4E51F37_INCLUDED
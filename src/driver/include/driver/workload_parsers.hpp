@@ -15,9 +15,16 @@
 #ifndef HEADER_0369D27D_9A68_4981_B344_4BAB3EE09A80_INCLUDED
 #define HEADER_0369D27D_9A68_4981_B344_4BAB3EE09A80_INCLUDED
 
+#include <set>
+#include <string>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 #include <yaml-cpp/yaml.h>
 
+#include <gennylib/Orchestrator.hpp>
+#include <gennylib/conventions.hpp>
+
 #include <driver/v1/DefaultDriver.hpp>
 
 namespace genny::driver::v1 {
@@ -36,14 +43,30 @@ public:
     explicit WorkloadParser(fs::path phaseConfigPath)
         : _phaseConfigPath{std::move(phaseConfigPath)} {};
 
+    /**
+     * @param params
+     *   values for `^Parameter`s by name. These take precedence over the `Parameters`
+     *   of an `ExternalPhaseConfig` and the `Default` of the `^Parameter` itself.
+     */
+    WorkloadParser(fs::path phaseConfigPath, YamlParameters params)
+        : _params{std::move(params)}, _phaseConfigPath{std::move(phaseConfigPath)} {};
+
     YAML::Node parse(const std::string& source,
                      DefaultDriver::ProgramOptions::YamlSource =
                          DefaultDriver::ProgramOptions::YamlSource::kFile,
                      Mode mode = Mode::kNormal);
 
+    /**
+     * @return the `Name` of every `^Parameter` replaced by `parse()` so far.
+     */
+    const std::set<std::string>& parameterNames() const {
+        return _parameterNames;
+    }
+
 private:
     YamlParameters _params;
     const fs::path _phaseConfigPath;
+    std::set<std::string> _parameterNames;
 
     YAML::Node recursiveParse(YAML::Node);
 
@@ -62,6 +85,28 @@ public:
     static YAML::Node convert(YAML::Node workloadRoot);
 };
 
+/**
+ * Convert a fully-parsed workload YAML into one that only runs a single phase, e.g. so setup
+ * phases (loading data etc.) aren't repeated every time a phase is measured.
+ *
+ * Each Actor's block for the phase is kept. A block for a range of phases that includes it is
+ * split so only that phase runs. Every other block is replaced by `{Phase: <same>, Nop: true}`
+ * so nothing like a `Duration` is left to loop over. Only `Threads` is kept so the same Actors
+ * are constructed.
+ */
+class OnlyPhaseConverter {
+public:
+    /**
+     * @param workloadRoot not modified.
+     */
+    static YAML::Node convert(const YAML::Node& workloadRoot, PhaseNumber phase);
+};
+
+/**
+ * @return the phases each block of an Actor's `Phases:` is for, in order.
+ */
+std::vector<PhaseRangeSpec> phaseRanges(const YAML::Node& phases);
+
 }  // namespace genny::driver::v1
 
 
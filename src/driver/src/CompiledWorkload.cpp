@@ -0,0 +1,266 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/CompiledWorkload.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+constexpr std::string_view kMagic{"GENNYWC\n"};
+// Bump whenever the layout below changes.
+constexpr uint32_t kFormatVersion = 1;
+
+constexpr uint32_t kNoTag = UINT32_MAX;
+
+enum class Kind : uint8_t {
+    kNull = 0,
+    kScalar = 1,
+    kSequence = 2,
+    kMap = 3,
+};
+
+template <typename T>
+void put(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class Writer {
+public:
+    void node(const YAML::Node& node) {
+        switch (node.Type()) {
+            case YAML::NodeType::Scalar:
+                header(Kind::kScalar, node);
+                put(_nodes, intern(node.Scalar()));
+                break;
+            case YAML::NodeType::Sequence:
+                header(Kind::kSequence, node);
+                put(_nodes, uint32_t(node.size()));
+                for (const auto& child : node) {
+                    this->node(child);
+                }
+                break;
+            case YAML::NodeType::Map:
+                header(Kind::kMap, node);
+                put(_nodes, uint32_t(node.size()));
+                for (const auto& kvp : node) {
+                    this->node(kvp.first);
+                    this->node(kvp.second);
+                }
+                break;
+            case YAML::NodeType::Null:
+            case YAML::NodeType::Undefined:
+                header(Kind::kNull, node);
+                break;
+        }
+    }
+
+    void finish(std::ostream& out) {
+        out.write(kMagic.data(), kMagic.size());
+        put(out, kFormatVersion);
+        put(out, uint32_t(_strings.size()));
+        for (const auto& str : _strings) {
+            put(out, uint32_t(str.size()));
+            out.write(str.data(), str.size());
+        }
+        out << _nodes.rdbuf();
+    }
+
+private:
+    void header(Kind kind, const YAML::Node& node) {
+        put(_nodes, kind);
+        put(_nodes, node.Tag().empty() ? kNoTag : intern(node.Tag()));
+    }
+
+    uint32_t intern(const std::string& str) {
+        auto [it, inserted] = _indexes.try_emplace(str, uint32_t(_strings.size()));
+        if (inserted) {
+            _strings.push_back(str);
+        }
+        return it->second;
+    }
+
+    std::unordered_map<std::string, uint32_t> _indexes;
+    std::vector<std::string> _strings;
+    std::stringstream _nodes;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) : _bytes{bytes} {}
+
+    YAML::Node workload() {
+        if (_bytes.substr(0, kMagic.size()) != kMagic) {
+            throw InvalidConfigurationException("Not a compiled workload");
+        }
+        _pos = kMagic.size();
+        if (const auto version = get<uint32_t>(); version != kFormatVersion) {
+            std::ostringstream msg;
+            msg << "Compiled workload has format version " << version << " but this genny reads "
+                << kFormatVersion << ". Recompile the workload.";
+            throw InvalidConfigurationException(msg.str());
+        }
+
+        // The strings stay in the mapped file, YAML::Node copies what it needs.
+        const auto count = get<uint32_t>();
+        _strings.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto size = get<uint32_t>();
+            _strings.push_back(take(size));
+        }
+
+        auto out = node();
+        if (_pos != _bytes.size()) {
+            throw InvalidConfigurationException("Trailing bytes after compiled workload");
+        }
+        return out;
+    }
+
+private:
+    YAML::Node node() {
+        const auto kind = get<Kind>();
+        const auto tag = get<uint32_t>();
+
+        YAML::Node out;
+        switch (kind) {
+            case Kind::kNull:
+                out = YAML::Node{YAML::NodeType::Null};
+                break;
+            case Kind::kScalar:
+                out = YAML::Node{std::string{string(get<uint32_t>())}};
+                break;
+            case Kind::kSequence: {
+                out = YAML::Node{YAML::NodeType::Sequence};
+                const auto size = get<uint32_t>();
+                for (uint32_t i = 0; i < size; ++i) {
+                    out.push_back(node());
+                }
+                break;
+            }
+            case Kind::kMap: {
+                out = YAML::Node{YAML::NodeType::Map};
+                const auto size = get<uint32_t>();
+                for (uint32_t i = 0; i < size; ++i) {
+                    auto key = node();
+                    out[key] = node();
+                }
+                break;
+            }
+            default:
+                throw InvalidConfigurationException("Corrupt compiled workload");
+        }
+        if (tag != kNoTag) {
+            out.SetTag(std::string{string(tag)});
+        }
+        return out;
+    }
+
+    template <typename T>
+    T get() {
+        T out;
+        std::memcpy(&out, take(sizeof(T)).data(), sizeof(T));
+        return out;
+    }
+
+    std::string_view take(size_t size) {
+        if (_bytes.size() - _pos < size) {
+            throw InvalidConfigurationException("Truncated compiled workload");
+        }
+        auto out = _bytes.substr(_pos, size);
+        _pos += size;
+        return out;
+    }
+
+    std::string_view string(uint32_t index) const {
+        if (index >= _strings.size()) {
+            throw InvalidConfigurationException("Corrupt compiled workload");
+        }
+        return _strings[index];
+    }
+
+    const std::string_view _bytes;
+    size_t _pos = 0;
+    std::vector<std::string_view> _strings;
+};
+
+[[noreturn]] void failedToLoad(const std::string& path) {
+    throw InvalidConfigurationException("Can't load compiled workload " + path + ": " +
+                                        std::strerror(errno));
+}
+
+}  // namespace
+
+
+void CompiledWorkload::write(const YAML::Node& workload, std::ostream& out) {
+    Writer writer;
+    writer.node(workload);
+    writer.finish(out);
+}
+
+YAML::Node CompiledWorkload::read(std::string_view bytes) {
+    return Reader{bytes}.workload();
+}
+
+YAML::Node CompiledWorkload::load(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        failedToLoad(path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        failedToLoad(path);
+    }
+    const auto size = size_t(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return read({});
+    }
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        failedToLoad(path);
+    }
+    try {
+        auto out = read({static_cast<const char*>(mapped), size});
+        ::munmap(mapped, size);
+        return out;
+    } catch (...) {
+        ::munmap(mapped, size);
+        throw;
+    }
+}
+
+bool CompiledWorkload::isCompiled(const std::string& path) {
+    std::ifstream in{path, std::ios::binary};
+    std::string start(kMagic.size(), '\0');
+    return in.read(start.data(), start.size()) && start == kMagic;
+}
+
+}  // namespace genny::driver::v1
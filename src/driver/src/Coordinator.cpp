@@ -0,0 +1,338 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/Coordinator.hpp>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+#include <gennylib/conventions.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+// Workers may well be started before the coordinator.
+constexpr int kConnectAttempts = 300;
+constexpr auto kConnectRetryInterval = std::chrono::milliseconds{100};
+
+// Longest `<kind> <number> <payload-size>` line we accept.
+constexpr size_t kMaxHeaderSize = 256;
+
+struct Message {
+    std::string kind;
+    int64_t number = 0;
+    std::string payload;
+};
+
+void send(tcp::socket& socket, const Message& message) {
+    if (message.payload.size() > Coordinator::kMaxPayloadSize) {
+        throw std::runtime_error("Can't send a " + std::to_string(message.payload.size()) +
+                                 " byte " + message.kind + " message, the most is " +
+                                 std::to_string(Coordinator::kMaxPayloadSize));
+    }
+    std::ostringstream header;
+    header << message.kind << " " << message.number << " " << message.payload.size() << "\n";
+    const auto headerStr = header.str();
+    const std::array<asio::const_buffer, 2> buffers{asio::buffer(headerStr),
+                                                    asio::buffer(message.payload)};
+    asio::write(socket, buffers);
+}
+
+Message receive(tcp::socket& socket) {
+    // Headers are tiny and there are only a few messages per phase so reading
+    // a byte at a time is fine.
+    std::string header;
+    char c;
+    while (true) {
+        asio::read(socket, asio::buffer(&c, 1));
+        if (c == '\n') {
+            break;
+        }
+        header.push_back(c);
+        if (header.size() > kMaxHeaderSize) {
+            throw std::runtime_error("Malformed message from peer");
+        }
+    }
+
+    Message out;
+    size_t size;
+    std::istringstream in{header};
+    if (!(in >> out.kind >> out.number >> size)) {
+        throw std::runtime_error("Malformed message header '" + header + "'");
+    }
+    // Don't let a broken or hostile peer make us allocate whatever it claims to send.
+    if (size > Coordinator::kMaxPayloadSize) {
+        throw std::runtime_error("Peer announced a " + std::to_string(size) + " byte " +
+                                 out.kind + " message, the most is " +
+                                 std::to_string(Coordinator::kMaxPayloadSize));
+    }
+    out.payload.resize(size);
+    if (size > 0) {
+        asio::read(socket, asio::buffer(out.payload));
+    }
+    return out;
+}
+
+Message receive(tcp::socket& socket, const std::string& expectedKind) {
+    auto message = receive(socket);
+    if (message.kind != expectedKind) {
+        throw std::runtime_error("Expected " + expectedKind + " message but got " +
+                                 message.kind);
+    }
+    return message;
+}
+
+std::pair<std::string, std::string> splitAddress(const std::string& address) {
+    const auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw InvalidConfigurationException("Coordinator address must be host:port. Gave '" +
+                                            address + "'");
+    }
+    return {address.substr(0, colon), address.substr(colon + 1)};
+}
+
+int64_t threadsOf(const YAML::Node& node, int64_t defaultThreads) {
+    return node["Threads"] ? node["Threads"].as<IntegerSpec>().value : defaultThreads;
+}
+
+}  // namespace
+
+
+Coordinator::Coordinator(const std::string& address, size_t processes)
+    : _processes{processes}, _acceptor{_io} {
+    if (processes == 0) {
+        throw InvalidConfigurationException("Need at least one worker process");
+    }
+    const auto [host, port] = splitAddress(address);
+    const auto endpoint = *tcp::resolver{_io}.resolve(host, port).begin();
+
+    _acceptor.open(endpoint.endpoint().protocol());
+    _acceptor.set_option(tcp::acceptor::reuse_address(true));
+    _acceptor.bind(endpoint);
+    _acceptor.listen();
+}
+
+uint16_t Coordinator::port() const {
+    return _acceptor.local_endpoint().port();
+}
+
+std::vector<WorkerResult> Coordinator::run(const YAML::Node& workload,
+                                           const std::string& workloadName,
+                                           const std::string& metricsFormat) {
+    BOOST_LOG_TRIVIAL(info) << "Waiting for " << _processes << " workers on port " << port();
+
+    std::vector<tcp::socket> sockets;
+    sockets.reserve(_processes);
+    for (size_t i = 0; i < _processes; ++i) {
+        sockets.emplace_back(_io);
+        _acceptor.accept(sockets.back());
+        BOOST_LOG_TRIVIAL(info) << "Worker " << i << " connected from "
+                                << sockets.back().remote_endpoint();
+
+        YAML::Node assignment;
+        assignment["Index"] = i;
+        assignment["Processes"] = _processes;
+        assignment["WorkloadName"] = workloadName;
+        assignment["MetricsFormat"] = metricsFormat;
+        assignment["Workload"] = shareOf(workload, i, _processes);
+        send(sockets.back(), {"ASSIGN", int64_t(i), YAML::Dump(assignment)});
+    }
+
+    std::vector<WorkerResult> results(_processes);
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<std::optional<PhaseNumber>> ready(_processes);
+    std::vector<bool> done(_processes, false);
+
+    // Finished (or failed) workers never hold up a phase.
+    auto everyoneReady = [&](PhaseNumber phase) {
+        for (size_t i = 0; i < _processes; ++i) {
+            if (!done[i] && (!ready[i] || *ready[i] < phase)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < _processes; ++i) {
+        threads.emplace_back([&, i]() {
+            auto& socket = sockets[i];
+            try {
+                while (true) {
+                    auto message = receive(socket);
+                    if (message.kind == "READY") {
+                        const auto phase = static_cast<PhaseNumber>(message.number);
+                        {
+                            std::unique_lock<std::mutex> lk{lock};
+                            ready[i] = phase;
+                            changed.notify_all();
+                            changed.wait(lk, [&]() { return everyoneReady(phase); });
+                        }
+                        send(socket, {"START", message.number, ""});
+                    } else if (message.kind == "DONE") {
+                        std::lock_guard<std::mutex> lk{lock};
+                        results[i].outcome =
+                            static_cast<DefaultDriver::OutcomeCode>(message.number);
+                        results[i].report = std::move(message.payload);
+                        done[i] = true;
+                        changed.notify_all();
+                        return;
+                    } else {
+                        throw std::runtime_error("Unexpected " + message.kind + " message");
+                    }
+                }
+            } catch (const std::exception& x) {
+                BOOST_LOG_TRIVIAL(error) << "Lost worker " << i << ": " << x.what();
+                std::lock_guard<std::mutex> lk{lock};
+                results[i].outcome = DefaultDriver::OutcomeCode::kInternalException;
+                done[i] = true;
+                changed.notify_all();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+YAML::Node Coordinator::shareOf(const YAML::Node& workload, size_t index, size_t processes) {
+    auto out = YAML::Clone(workload);
+
+    // A GlobalRate is shared by every thread using its rate limiter. Blocks naming the same
+    // RateLimiterName share one limiter, so it's scaled by the share of all of their threads
+    // rather than once per block.
+    struct Users {
+        int64_t threads = 0;
+        int64_t mine = 0;
+    };
+    std::map<std::string, Users> namedLimiters;
+    std::vector<std::pair<YAML::Node, Users>> rates;
+
+    size_t actorIndex = 0;
+    for (auto actor : out["Actors"]) {
+        // This worker's position in the order leftover threads are handed out for this Actor.
+        const auto slot = int64_t((index + processes - actorIndex % processes) % processes);
+        ++actorIndex;
+
+        const auto count = int64_t(processes);
+        auto share = [&](int64_t threads) {
+            return threads / count + (slot < threads % count ? 1 : 0);
+        };
+
+        const auto actorThreads = threadsOf(actor, 1);
+        actor["Threads"] = share(actorThreads);
+
+        auto phases = actor["Phases"];
+        if (!phases.IsSequence()) {
+            continue;
+        }
+        for (auto block : phases) {
+            const auto threads = threadsOf(block, actorThreads);
+            const auto mine = share(threads);
+            if (block["Threads"]) {
+                block["Threads"] = mine;
+            }
+            if (!block["GlobalRate"]) {
+                continue;
+            }
+            if (const auto name = block["RateLimiterName"]) {
+                auto& users = namedLimiters[name.as<std::string>()];
+                users.threads += threads;
+                users.mine += mine;
+            }
+            rates.emplace_back(block, Users{threads, mine});
+        }
+    }
+
+    for (auto& [block, users] : rates) {
+        if (const auto name = block["RateLimiterName"]) {
+            users = namedLimiters[name.as<std::string>()];
+        }
+        if (users.mine > 0) {
+            // Keep the burst size and stretch the interval so the rates of all
+            // workers add up to the configured one.
+            auto rate = block["GlobalRate"].as<RateSpec>();
+            rate.per = rate.per * users.threads / users.mine;
+            block["GlobalRate"] = rate;
+        }
+    }
+    return out;
+}
+
+
+CoordinatorClient::CoordinatorClient(const std::string& address) : _socket{_io} {
+    const auto [host, port] = splitAddress(address);
+    for (int attempt = 1;; ++attempt) {
+        try {
+            asio::connect(_socket, tcp::resolver{_io}.resolve(host, port));
+            return;
+        } catch (const boost::system::system_error& x) {
+            if (attempt == kConnectAttempts) {
+                throw;
+            }
+            BOOST_LOG_TRIVIAL(debug) << "Coordinator at " << address
+                                     << " not reachable yet: " << x.what();
+            std::this_thread::sleep_for(kConnectRetryInterval);
+        }
+    }
+}
+
+CoordinatorClient::Assignment CoordinatorClient::awaitAssignment() {
+    const auto message = receive(_socket, "ASSIGN");
+    const auto yaml = YAML::Load(message.payload);
+    return {yaml["Index"].as<size_t>(),
+            yaml["Processes"].as<size_t>(),
+            yaml["WorkloadName"].as<std::string>(),
+            yaml["MetricsFormat"].as<std::string>(),
+            yaml["Workload"]};
+}
+
+void CoordinatorClient::awaitPhaseStart(PhaseNumber phase) {
+    send(_socket, {"READY", int64_t(phase), ""});
+    const auto message = receive(_socket, "START");
+    if (message.number != int64_t(phase)) {
+        std::ostringstream msg;
+        msg << "Ready for phase " << phase << " but coordinator started phase "
+            << message.number;
+        throw std::logic_error(msg.str());
+    }
+}
+
+void CoordinatorClient::finish(DefaultDriver::OutcomeCode outcome, const std::string& report) {
+    send(_socket, {"DONE", static_cast<int64_t>(outcome), report});
+}
+
+}  // namespace genny::driver::v1
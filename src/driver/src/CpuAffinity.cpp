@@ -0,0 +1,195 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/CpuAffinity.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+namespace genny::driver::v1 {
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+const auto kSysfsNodes = "/sys/devices/system/node";
+
+// NUMA node of each CPU according to sysfs.
+std::map<int, int> numaNodesByCpu() {
+    std::map<int, int> out;
+    boost::system::error_code ec;
+    for (fs::directory_iterator it{kSysfsNodes, ec}, end; !ec && it != end; it.increment(ec)) {
+        const auto name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+        std::ifstream cpuList{(it->path() / "cpulist").string()};
+        std::string line;
+        if (!std::getline(cpuList, line)) {
+            continue;
+        }
+        for (auto cpu : parseCpuList(line)) {
+            out[cpu] = std::stoi(name.substr(4));
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+std::vector<int> parseCpuList(const std::string& cpuList) {
+    std::vector<int> out;
+    std::istringstream in{cpuList};
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            size_t end;
+            const auto first = std::stoi(range, &end);
+            auto last = first;
+            if (end < range.size()) {
+                if (range[end] != '-') {
+                    throw std::invalid_argument(range);
+                }
+                size_t lastEnd;
+                last = std::stoi(range.substr(end + 1), &lastEnd);
+                if (end + 1 + lastEnd != range.size()) {
+                    throw std::invalid_argument(range);
+                }
+            }
+            if (first < 0 || last < first) {
+                throw std::invalid_argument(range);
+            }
+            for (auto cpu = first; cpu <= last; ++cpu) {
+                out.push_back(cpu);
+            }
+        } catch (const std::logic_error&) {
+            throw InvalidConfigurationException("Invalid CPU list '" + cpuList + "'");
+        }
+    }
+    if (out.empty()) {
+        throw InvalidConfigurationException("Empty CPU list '" + cpuList + "'");
+    }
+    return out;
+}
+
+CpuTopology discoverCpuTopology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        throw std::runtime_error("Couldn't get the CPU affinity of the process");
+    }
+
+    const auto nodes = numaNodesByCpu();
+    CpuTopology out;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            const auto node = nodes.find(cpu);
+            out.push_back({cpu, node == nodes.end() ? 0 : node->second});
+        }
+    }
+    return out;
+}
+
+CpuAffinity::CpuAffinity(const std::string& spec) {
+    if (spec == "none") {
+        _policy = Policy::kNone;
+    } else if (spec == "compact") {
+        _policy = Policy::kCompact;
+    } else if (spec == "spread") {
+        _policy = Policy::kSpread;
+    } else {
+        _policy = Policy::kExplicit;
+        _cpus = parseCpuList(spec);
+    }
+}
+
+std::vector<CpuSlot> CpuAffinity::plan(size_t threads, const CpuTopology& topology) const {
+    if (_policy == Policy::kNone || threads == 0) {
+        return {};
+    }
+    if (topology.empty()) {
+        throw InvalidConfigurationException("No CPUs available to pin actors to");
+    }
+
+    std::vector<CpuSlot> out;
+    out.reserve(threads);
+
+    if (_policy == Policy::kExplicit) {
+        for (size_t i = 0; i < threads; ++i) {
+            const auto cpu = _cpus[i % _cpus.size()];
+            auto slot = std::find_if(
+                topology.begin(), topology.end(), [&](const auto& s) { return s.cpu == cpu; });
+            if (slot == topology.end()) {
+                throw InvalidConfigurationException("CPU " + std::to_string(cpu) +
+                                                    " isn't available to this process");
+            }
+            out.push_back(*slot);
+        }
+        return out;
+    }
+
+    std::map<int, std::vector<CpuSlot>> byNode;
+    for (const auto& slot : topology) {
+        byNode[slot.numaNode].push_back(slot);
+    }
+
+    if (_policy == Policy::kCompact) {
+        std::vector<CpuSlot> ordered;
+        for (const auto& [node, slots] : byNode) {
+            ordered.insert(ordered.end(), slots.begin(), slots.end());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            out.push_back(ordered[i % ordered.size()]);
+        }
+        return out;
+    }
+
+    // Spread: the i'th thread goes to node i % nodes.
+    std::vector<const std::vector<CpuSlot>*> nodes;
+    for (const auto& [node, slots] : byNode) {
+        nodes.push_back(&slots);
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        const auto& slots = *nodes[i % nodes.size()];
+        out.push_back(slots[(i / nodes.size()) % slots.size()]);
+    }
+    return out;
+}
+
+void CpuAffinity::pinCurrentThread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); err != 0) {
+        BOOST_LOG_TRIVIAL(warning) << "Couldn't pin thread to CPU " << cpu << ": error " << err;
+    }
+}
+
+}  // namespace genny::driver::v1
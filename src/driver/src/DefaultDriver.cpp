@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <fstream>
+#include <functional>
+#include <optional>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -30,12 +33,21 @@
 #include <loki/ScopeGuard.h>
 
 #include <gennylib/Cast.hpp>
+#include <gennylib/InvalidConfigurationException.hpp>
 #include <gennylib/context.hpp>
 
 #include <metrics/MetricsReporter.hpp>
 #include <metrics/metrics.hpp>
 
+#include <driver/v1/CompiledWorkload.hpp>
+#include <driver/v1/Coordinator.hpp>
+#include <driver/v1/CpuAffinity.hpp>
 #include <driver/v1/DefaultDriver.hpp>
+#include <driver/v1/FiberPool.hpp>
+#include <driver/v1/ParameterSweep.hpp>
+#include <driver/v1/PerfCounters.hpp>
+#include <driver/v1/ReportMerger.hpp>
+#include <driver/v1/SaturationSearch.hpp>
 #include <driver/workload_parsers.hpp>
 
 namespace genny::driver {
@@ -65,6 +77,433 @@ void runActor(Actor&& actor,
     }
 }
 
+/**
+ * How many threads to construct Actors on.
+ */
+size_t setupThreads(const DefaultDriver::ProgramOptions& options) {
+    return options.setupThreads > 0 ? options.setupThreads
+                                    : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * Call `hook` with each phase's number just before the phase starts. Pre-phase-start hooks
+ * are called once for every phase in order, even the ones no Actor runs, so the phases can be
+ * counted here; the Orchestrator can't be asked as it holds its lock while calling them. A
+ * `blocking` hook is called without that lock and may wait, e.g. on other processes.
+ */
+void onPhaseStart(Orchestrator& orchestrator,
+                  bool blocking,
+                  std::function<void(PhaseNumber)> hook) {
+    auto counted = [hook = std::move(hook), phase = PhaseNumber{0}](const Orchestrator*) mutable {
+        hook(phase++);
+    };
+    if (blocking) {
+        orchestrator.addBlockingPrePhaseStartHook(std::move(counted));
+    } else {
+        orchestrator.addPrePhaseStartHook(std::move(counted));
+    }
+}
+
+/**
+ * Run every actor on its own thread (or fiber) and wait for them all to finish.
+ */
+DefaultDriver::OutcomeCode runActors(const ActorVector& actors,
+                                     Orchestrator& orchestrator,
+                                     genny::metrics::Registry& metrics,
+                                     const std::string& workloadName,
+                                     const DefaultDriver::ProgramOptions& options) {
+    auto startedActors = metrics.operation(workloadName, "ActorStarted", 0u);
+    auto finishedActors = metrics.operation(workloadName, "ActorFinished", 0u);
+
+    std::atomic<DefaultDriver::OutcomeCode> outcomeCode = DefaultDriver::OutcomeCode::kSuccess;
+
+    const auto affinity = v1::CpuAffinity{options.cpuAffinity};
+    const auto fibers = options.execution == DefaultDriver::ProgramOptions::Execution::kFibers;
+    const auto workers = options.workers > 0
+        ? options.workers
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<v1::CpuSlot> placement;
+    if (affinity.policy() != v1::CpuAffinity::Policy::kNone) {
+        placement = affinity.plan(fibers ? workers : actors.size(), v1::discoverCpuTopology());
+    }
+    if (fibers) {
+        // Recorded up-front because the Registry isn't thread-safe.
+        for (size_t worker = 0; worker < placement.size(); ++worker) {
+            const auto& slot = placement[worker];
+            metrics.recordWorkerPlacement(worker, slot.cpu, slot.numaNode);
+        }
+    }
+
+    // Shared with the pre-phase-start hook which the Orchestrator keeps after we return.
+    std::shared_ptr<v1::PerfCounterSampler> perfCounters;
+    if (options.perfCounters && fibers) {
+        BOOST_LOG_TRIVIAL(warning) << "--perf-counters counts per actor thread and can't be used "
+                                      "with fibers. Running without them.";
+    } else if (options.perfCounters) {
+        perfCounters =
+            std::make_shared<v1::PerfCounterSampler>(metrics, options.perfCountersWindow);
+        onPhaseStart(orchestrator, false, [perfCounters](PhaseNumber phase) {
+            perfCounters->phaseStarting(phase);
+        });
+    }
+
+    std::mutex reporting;
+    std::vector<std::function<void()>> tasks;
+    for (const auto& actor : actors) {
+        std::optional<int> cpu;
+        if (!fibers && !placement.empty()) {
+            const auto& slot = placement[tasks.size()];
+            cpu = slot.cpu;
+            // Recorded up-front because the Registry isn't thread-safe.
+            metrics.recordPlacement(actor->id(), slot.cpu, slot.numaNode);
+        }
+
+        tasks.emplace_back([&, cpu]() {
+            if (cpu) {
+                // Pin before the actor records anything so the pages backing its metrics are
+                // first touched, and therefore allocated, on the local NUMA node.
+                v1::CpuAffinity::pinCurrentThread(*cpu);
+            }
+            if (perfCounters) {
+                perfCounters->attachCurrentThread(actor->id());
+            }
+
+            {
+                auto ctx = startedActors.start();
+                ctx.addDocuments(1);
+
+                std::lock_guard<std::mutex> lk{reporting};
+                ctx.success();
+            }
+
+            runActor(actor, outcomeCode, orchestrator);
+
+            if (perfCounters) {
+                perfCounters->detach(actor->id());
+            }
+
+            {
+                auto ctx = finishedActors.start();
+                ctx.addDocuments(1);
+
+                std::lock_guard<std::mutex> lk{reporting};
+                ctx.success();
+            }
+        });
+    }
+
+    if (fibers) {
+        BOOST_LOG_TRIVIAL(info) << "Running " << tasks.size() << " actors on " << workers
+                                << " worker threads";
+        // Fibers move between workers so only the workers themselves can be pinned.
+        v1::runOnFibers(tasks, workers, [&](size_t worker) {
+            if (!placement.empty()) {
+                const auto& slot = placement[worker];
+                BOOST_LOG_TRIVIAL(info) << "Pinning worker " << worker << " to CPU " << slot.cpu
+                                        << " on NUMA node " << slot.numaNode;
+                v1::CpuAffinity::pinCurrentThread(slot.cpu);
+            }
+        });
+        return outcomeCode;
+    }
+
+    std::vector<std::thread> threads;
+    for (const auto& task : tasks)
+        threads.emplace_back(task);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return outcomeCode;
+}
+
+/**
+ * What runMeasured() saw of the measured phase(s).
+ */
+struct MeasuredRun {
+    DefaultDriver::OutcomeCode outcome;
+    // Unset if the workload never got to the measured phase.
+    std::optional<genny::metrics::time_point> started;
+    genny::metrics::time_point finished;
+};
+
+/**
+ * Run a saturation trial or sweep point's Actors, timing `phase` or, without one, the whole
+ * workload. The driver's own bookkeeping is recorded under "Genny" so it isn't mistaken for
+ * operations against the system under test.
+ */
+MeasuredRun runMeasured(WorkloadContext& workloadContext,
+                        Orchestrator& orchestrator,
+                        genny::metrics::Registry& registry,
+                        std::optional<PhaseNumber> phase,
+                        const DefaultDriver::ProgramOptions& options) {
+    orchestrator.addRequiredTokens(
+        int(std::distance(workloadContext.actors().begin(), workloadContext.actors().end())));
+
+    struct PhaseTimes {
+        std::optional<genny::metrics::time_point> started;
+        std::optional<genny::metrics::time_point> ended;
+    };
+    // Shared with the hook which the Orchestrator keeps after we return.
+    auto times = std::make_shared<PhaseTimes>();
+    onPhaseStart(orchestrator, false, [times, phase](PhaseNumber starting) {
+        if (starting == phase.value_or(0)) {
+            times->started = genny::metrics::clock::now();
+        } else if (phase && starting == *phase + 1) {
+            times->ended = genny::metrics::clock::now();
+        }
+    });
+
+    const auto outcome =
+        runActors(workloadContext.actors(), orchestrator, registry, "Genny", options);
+    return {outcome, times->started, times->ended.value_or(genny::metrics::clock::now())};
+}
+
+// A trial only counts as sustaining its rate if the actors achieved at least this fraction of it.
+constexpr double kSustainedFraction = 0.9;
+
+/**
+ * Repeatedly run the configured phase at different GlobalRates and bisect towards the
+ * highest rate that meets the latency SLO. Each trial gets its own metrics and
+ * WorkloadContext so latencies from one trial can't leak into the next.
+ */
+DefaultDriver::OutcomeCode runSaturationSearch(const YAML::Node& yaml,
+                                               const DefaultDriver::ProgramOptions& options,
+                                               const std::string& sourceName) {
+    const auto& saturation = options.saturation;
+    if (saturation.latency.empty()) {
+        throw InvalidConfigurationException("Must specify a latency SLO for saturate");
+    }
+    if (saturation.percentile <= 0 || saturation.percentile > 100) {
+        std::ostringstream msg;
+        msg << "Latency percentile must be in (0, 100]. Gave " << saturation.percentile;
+        throw InvalidConfigurationException(msg.str());
+    }
+    const auto slo = YAML::Load(saturation.latency).as<TimeSpec>();
+
+    v1::SaturationSearch search{saturation.minRate, saturation.maxRate, saturation.maxTrials};
+
+    while (const auto rate = search.nextRate()) {
+        const bool isFirstTrial = search.trajectory().empty();
+        auto trialYaml =
+            v1::SaturationSearch::configureTrial(yaml, saturation.phase, *rate, !isFirstTrial);
+
+        genny::metrics::Registry registry;
+        auto orchestrator = Orchestrator{};
+        NodeSource nodeSource{YAML::Dump(trialYaml), sourceName};
+        auto workloadContext = WorkloadContext{nodeSource.root(),
+                                               registry,
+                                               orchestrator,
+                                               options.mongoUri,
+                                               globalCast(),
+                                               {},
+                                               setupThreads(options)};
+
+        const auto run =
+            runMeasured(workloadContext, orchestrator, registry, saturation.phase, options);
+        if (run.outcome != DefaultDriver::OutcomeCode::kSuccess) {
+            return run.outcome;
+        }
+        if (!run.started) {
+            std::ostringstream msg;
+            msg << "Workload never reached saturation phase " << saturation.phase;
+            throw InvalidConfigurationException(msg.str());
+        }
+
+        const auto sketch =
+            genny::metrics::Reporter{registry}.sketchLatencies(*run.started, run.finished);
+        const auto seconds = std::chrono::duration<double>(run.finished - *run.started).count();
+        // GlobalRate limits iterations rather than operations so that's what must keep up.
+        const auto iterations = workloadContext.iterations(saturation.phase);
+        const double throughput = seconds > 0 ? double(iterations) / seconds : 0;
+        const auto latency = sketch.quantile(saturation.percentile / 100);
+        const bool meetsSlo = sketch.count() > 0 && latency <= slo.value &&
+            throughput >= kSustainedFraction * double(*rate);
+
+        BOOST_LOG_TRIVIAL(info) << "Saturation trial at " << *rate << " iterations/s: achieved "
+                                << throughput << " iterations/s with p" << saturation.percentile
+                                << " latency " << latency.count() << "ns"
+                                << (meetsSlo ? "" : " (does not meet SLO)");
+        search.record({*rate, throughput, latency, meetsSlo});
+    }
+
+    if (const auto best = search.best()) {
+        BOOST_LOG_TRIVIAL(info) << "Highest rate meeting the SLO: " << *best << " iterations/s";
+    } else {
+        BOOST_LOG_TRIVIAL(warning) << "No rate met the SLO";
+    }
+
+    std::ofstream output;
+    output.open(options.metricsOutputFileName, std::ofstream::out | std::ofstream::trunc);
+    search.report(output);
+
+    return DefaultDriver::OutcomeCode::kSuccess;
+}
+
+/**
+ * Run the workload once for every combination of the swept parameters and report one row
+ * per point. Connection-pools are kept open between points and, if a phase is given, the
+ * other phases (e.g. loading data) only run for the first point.
+ */
+DefaultDriver::OutcomeCode runParameterSweep(const DefaultDriver::ProgramOptions& options,
+                                             const fs::path& phaseConfigSource,
+                                             const std::string& sourceName) {
+    const auto& measuredPhase = options.sweep.phase;
+    v1::ParameterSweep sweep{options.sweep.parameters};
+    auto poolManager = std::make_shared<genny::v1::PoolManager>(
+        options.mongoUri, genny::v1::PoolManager::OnCommandStartCallback{});
+
+    auto outcome = DefaultDriver::OutcomeCode::kSuccess;
+    for (const auto& point : sweep.points()) {
+        const bool isFirstPoint = sweep.results().empty();
+
+        v1::WorkloadParser parser{phaseConfigSource, point.parameters()};
+        auto yaml = parser.parse(options.workloadSource,
+                                 options.workloadSourceType,
+                                 options.isSmokeTest ? v1::WorkloadParser::Mode::kSmokeTest
+                                                     : v1::WorkloadParser::Mode::kNormal);
+        if (isFirstPoint) {
+            sweep.checkParameters(parser.parameterNames());
+        }
+        if (measuredPhase && !isFirstPoint) {
+            yaml = v1::OnlyPhaseConverter::convert(yaml, *measuredPhase);
+        }
+        if (!isFirstPoint) {
+            // The last point's Actors are gone, don't let this point's see what they left.
+            WorkloadContext::resetActorSharedState();
+        }
+
+        genny::metrics::Registry registry;
+        auto orchestrator = Orchestrator{};
+        NodeSource nodeSource{YAML::Dump(yaml), sourceName};
+        auto workloadContext = WorkloadContext{nodeSource.root(),
+                                               registry,
+                                               orchestrator,
+                                               poolManager,
+                                               globalCast(),
+                                               setupThreads(options)};
+
+        const auto run =
+            runMeasured(workloadContext, orchestrator, registry, measuredPhase, options);
+        outcome = run.outcome;
+
+        const auto from = run.started.value_or(run.finished);
+        const auto sketch = genny::metrics::Reporter{registry}.sketchLatencies(from, run.finished);
+        const auto duration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(run.finished - from);
+        const auto seconds = std::chrono::duration<double>(duration).count();
+        const auto iterations = measuredPhase ? workloadContext.iterations(*measuredPhase)
+                                              : workloadContext.iterations();
+        const double throughput = seconds > 0 ? double(iterations) / seconds : 0;
+
+        std::ostringstream label;
+        for (const auto& [name, value] : point.values) {
+            label << " " << name << "=" << value;
+        }
+        BOOST_LOG_TRIVIAL(info) << "Sweep point" << label.str() << ": " << throughput
+                                << " iterations/s over " << iterations << " iterations";
+        sweep.record({outcome,
+                      iterations,
+                      sketch.count(),
+                      duration,
+                      throughput,
+                      sketch.quantile(0.5),
+                      sketch.quantile(0.99)});
+
+        if (outcome != DefaultDriver::OutcomeCode::kSuccess) {
+            BOOST_LOG_TRIVIAL(error) << "Stopping the sweep after a failed point";
+            break;
+        }
+        if (measuredPhase && !run.started) {
+            std::ostringstream msg;
+            msg << "Workload never reached sweep phase " << *measuredPhase;
+            throw InvalidConfigurationException(msg.str());
+        }
+    }
+
+    std::ofstream output;
+    output.open(options.metricsOutputFileName, std::ofstream::out | std::ofstream::trunc);
+    sweep.report(output);
+
+    return outcome;
+}
+
+/**
+ * Hand out shares of the workload to worker processes and merge their metrics. The
+ * coordinator runs no Actors itself.
+ */
+DefaultDriver::OutcomeCode runCoordinator(const YAML::Node& yaml,
+                                          const DefaultDriver::ProgramOptions& options,
+                                          const std::string& workloadName) {
+    v1::Coordinator coordinator{options.coordinator, options.processes};
+    const auto results = coordinator.run(yaml, workloadName, options.metricsFormat);
+
+    auto outcomeCode = DefaultDriver::OutcomeCode::kSuccess;
+    std::vector<std::string> reports;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].outcome != DefaultDriver::OutcomeCode::kSuccess) {
+            BOOST_LOG_TRIVIAL(error) << "Worker " << i << " failed with code "
+                                     << static_cast<int>(results[i].outcome);
+            if (outcomeCode == DefaultDriver::OutcomeCode::kSuccess) {
+                outcomeCode = results[i].outcome;
+            }
+        }
+        if (!results[i].report.empty()) {
+            reports.push_back(results[i].report);
+        }
+    }
+
+    if (!reports.empty()) {
+        std::ofstream metricsOutput;
+        metricsOutput.open(options.metricsOutputFileName,
+                           std::ofstream::out | std::ofstream::trunc);
+        v1::mergeReports(reports, metricsOutput);
+    }
+    return outcomeCode;
+}
+
+/**
+ * Run the share of a workload given by a coordinator, starting each phase only once
+ * every other worker is ready for it too.
+ */
+DefaultDriver::OutcomeCode runWorker(const DefaultDriver::ProgramOptions& options,
+                                     genny::metrics::Registry& metrics,
+                                     genny::metrics::OperationContext& setupCtx) {
+    v1::CoordinatorClient coordinator{options.coordinator};
+    const auto assignment = coordinator.awaitAssignment();
+    BOOST_LOG_TRIVIAL(info) << "Running as worker " << assignment.index << " of "
+                            << assignment.processes;
+
+    auto orchestrator = Orchestrator{};
+    NodeSource nodeSource{YAML::Dump(assignment.workload), "coordinator"};
+    auto workloadContext = WorkloadContext{nodeSource.root(),
+                                           metrics,
+                                           orchestrator,
+                                           options.mongoUri,
+                                           globalCast(),
+                                           {},
+                                           setupThreads(options)};
+
+    orchestrator.addRequiredTokens(
+        int(std::distance(workloadContext.actors().begin(), workloadContext.actors().end())));
+
+    // Waiting on the other workers can take a while.
+    onPhaseStart(orchestrator, true, [&coordinator](PhaseNumber phase) {
+        coordinator.awaitPhaseStart(phase);
+    });
+
+    setupCtx.success();
+
+    const auto outcomeCode = runActors(
+        workloadContext.actors(), orchestrator, metrics, assignment.workloadName, options);
+
+    std::ostringstream report;
+    genny::metrics::Reporter{metrics}.report(report, assignment.metricsFormat);
+    coordinator.finish(outcomeCode, report.str());
+
+    return outcomeCode;
+}
+
 DefaultDriver::OutcomeCode doRunLogic(const DefaultDriver::ProgramOptions& options) {
     // setup logging as the first thing we do.
     boost::log::core::get()->set_filter(boost::log::trivial::severity >= options.logVerbosity);
@@ -81,6 +520,11 @@ DefaultDriver::OutcomeCode doRunLogic(const DefaultDriver::ProgramOptions& optio
         return DefaultDriver::OutcomeCode::kSuccess;
     }
 
+    if (options.runMode == DefaultDriver::RunMode::kWork) {
+        // The coordinator sends the workload.
+        return runWorker(options, metrics, setupCtx);
+    }
+
     if (options.workloadSource.empty()) {
         std::cerr << "Must specify a workload YAML file" << std::endl;
         setupCtx.failure();
@@ -103,13 +547,25 @@ DefaultDriver::OutcomeCode doRunLogic(const DefaultDriver::ProgramOptions& optio
         phaseConfigSource = fs::path(options.workloadSource).parent_path();
     }
 
-    v1::WorkloadParser parser{phaseConfigSource};
+    YAML::Node yaml;
+    const bool isCompiled =
+        options.workloadSourceType == DefaultDriver::ProgramOptions::YamlSource::kFile &&
+        v1::CompiledWorkload::isCompiled(options.workloadSource);
+    if (isCompiled) {
+        // Already parsed by `genny compile`.
+        yaml = v1::CompiledWorkload::load(options.workloadSource);
+        if (options.isSmokeTest) {
+            yaml = v1::SmokeTestConverter::convert(yaml);
+        }
+    } else {
+        v1::WorkloadParser parser{phaseConfigSource};
 
-    // Consider passing in whole options struct if we pass in more than 2-3 fields.
-    auto yaml = parser.parse(options.workloadSource,
-                             options.workloadSourceType,
-                             options.isSmokeTest ? v1::WorkloadParser::Mode::kSmokeTest
-                                                 : v1::WorkloadParser::Mode::kNormal);
+        // Consider passing in whole options struct if we pass in more than 2-3 fields.
+        yaml = parser.parse(options.workloadSource,
+                            options.workloadSourceType,
+                            options.isSmokeTest ? v1::WorkloadParser::Mode::kSmokeTest
+                                                : v1::WorkloadParser::Mode::kNormal);
+    }
 
     auto orchestrator = Orchestrator{};
 
@@ -119,14 +575,39 @@ DefaultDriver::OutcomeCode doRunLogic(const DefaultDriver::ProgramOptions& optio
         return DefaultDriver::OutcomeCode::kSuccess;
     }
 
-    NodeSource nodeSource{YAML::Dump(yaml),
-                          options.workloadSourceType ==
-                                  DefaultDriver::ProgramOptions::YamlSource::kFile
-                              ? options.workloadSource
-                              : "inline-yaml"};
+    const auto sourceName =
+        options.workloadSourceType == DefaultDriver::ProgramOptions::YamlSource::kFile
+        ? options.workloadSource
+        : "inline-yaml";
 
-    auto workloadContext =
-        WorkloadContext{nodeSource.root(), metrics, orchestrator, options.mongoUri, globalCast()};
+    if (options.runMode == DefaultDriver::RunMode::kSaturate) {
+        setupCtx.success();
+        return runSaturationSearch(yaml, options, sourceName);
+    }
+
+    if (options.runMode == DefaultDriver::RunMode::kSweep) {
+        if (isCompiled) {
+            throw InvalidConfigurationException(
+                "Can't sweep the parameters of a compiled workload. Sweep the YAML instead.");
+        }
+        setupCtx.success();
+        return runParameterSweep(options, phaseConfigSource, sourceName);
+    }
+
+    if (options.runMode == DefaultDriver::RunMode::kCoordinate) {
+        setupCtx.success();
+        return runCoordinator(yaml, options, workloadName);
+    }
+
+    NodeSource nodeSource{yaml, sourceName};
+
+    auto workloadContext = WorkloadContext{nodeSource.root(),
+                                           metrics,
+                                           orchestrator,
+                                           options.mongoUri,
+                                           globalCast(),
+                                           {},
+                                           setupThreads(options)};
 
     if (options.runMode == DefaultDriver::RunMode::kDryRun) {
         std::cout << "Workload context constructed without errors." << std::endl;
@@ -134,45 +615,28 @@ DefaultDriver::OutcomeCode doRunLogic(const DefaultDriver::ProgramOptions& optio
         return DefaultDriver::OutcomeCode::kSuccess;
     }
 
+    if (options.runMode == DefaultDriver::RunMode::kCompile) {
+        {
+            std::ofstream out{options.compiledWorkloadFileName,
+                              std::ofstream::out | std::ofstream::trunc | std::ofstream::binary};
+            v1::CompiledWorkload::write(yaml, out);
+            if (!out) {
+                throw std::runtime_error("Failed to write " + options.compiledWorkloadFileName);
+            }
+        }
+        std::cout << "Compiled workload written to " << options.compiledWorkloadFileName
+                  << std::endl;
+        setupCtx.success();
+        return DefaultDriver::OutcomeCode::kSuccess;
+    }
+
     orchestrator.addRequiredTokens(
         int(std::distance(workloadContext.actors().begin(), workloadContext.actors().end())));
 
     setupCtx.success();
 
-    auto startedActors = metrics.operation(workloadName, "ActorStarted", 0u);
-    auto finishedActors = metrics.operation(workloadName, "ActorFinished", 0u);
-
-    std::atomic<DefaultDriver::OutcomeCode> outcomeCode = DefaultDriver::OutcomeCode::kSuccess;
-
-    std::mutex reporting;
-    std::vector<std::thread> threads;
-    std::transform(cbegin(workloadContext.actors()),
-                   cend(workloadContext.actors()),
-                   std::back_inserter(threads),
-                   [&](const auto& actor) {
-                       return std::thread{[&]() {
-                           {
-                               auto ctx = startedActors.start();
-                               ctx.addDocuments(1);
-
-                               std::lock_guard<std::mutex> lk{reporting};
-                               ctx.success();
-                           }
-
-                           runActor(actor, outcomeCode, orchestrator);
-
-                           {
-                               auto ctx = finishedActors.start();
-                               ctx.addDocuments(1);
-
-                               std::lock_guard<std::mutex> lk{reporting};
-                               ctx.success();
-                           }
-                       }};
-                   });
-
-    for (auto& thread : threads)
-        thread.join();
+    auto outcomeCode =
+        runActors(workloadContext.actors(), orchestrator, metrics, workloadName, options);
 
     const auto reporter = genny::metrics::Reporter{metrics};
 
@@ -264,6 +728,17 @@ DefaultDriver::ProgramOptions::ProgramOptions(int argc, char** argv) {
                  connections during workload initialization
     evaluate     Print the evaluated YAML workload file with minimal validation
     list-actors  List all actors available for use
+    saturate     Repeatedly run one phase at different GlobalRates to find the
+                 highest rate that meets a latency SLO
+    sweep        Run the workload once per combination of --sweep parameter
+                 values and report throughput and latency for each
+    coordinate   Split the workload across several `work` processes, keep their
+                 phases in step and merge their metrics
+    work         Run the share of a workload handed out by a coordinator
+    compile      Check the workload like dry-run and save it fully evaluated in a
+                 binary form that other subcommands load without parsing YAML.
+                 Written to the -o file or next to the workload with a .gwc
+                 extension
     )" << "\n";
 
     progDescStream << "🧞 Options";
@@ -280,7 +755,8 @@ DefaultDriver::ProgramOptions::ProgramOptions(int argc, char** argv) {
              "Metrics format to use")
             ("metrics-output-file,o",
              po::value<std::string>()->default_value("/dev/stdout"),
-             "Save metrics data to this file. Use `-` or `/dev/stdout` for stdout.")
+             "Save metrics data to this file. Use `-` or `/dev/stdout` for stdout. "
+             "For compile: where to save the compiled workload.")
             ("workload-file,w",
              po::value<std::string>(),
              "Path to workload configuration yaml file. "
@@ -294,7 +770,63 @@ DefaultDriver::ProgramOptions::ProgramOptions(int argc, char** argv) {
               "Log severity for boost logging. Valid values are trace/debug/info/warning/error/fatal.")
             ("smoke-test,s",
              po::value<bool>()->default_value(false),
-             "Run a workload in smoke test mode where all phases are set to Repeat=1");
+             "Run a workload in smoke test mode where all phases are set to Repeat=1")
+            ("execution",
+             po::value<std::string>()->default_value("threads"),
+             "How to schedule actors: 'threads' runs one OS thread per actor, "
+             "'fibers' multiplexes them over a bounded pool of worker threads")
+            ("workers",
+             po::value<size_t>()->default_value(0),
+             "For fibers execution: number of worker threads. Defaults to one per core.")
+            ("cpu-affinity",
+             po::value<std::string>()->default_value("none"),
+             "How to pin actor threads (or fiber workers) to CPUs: 'none', 'compact' to fill one "
+             "NUMA node at a time, 'spread' to round-robin across NUMA nodes, or a list of CPUs "
+             "such as '0,2,4-7' giving the CPU for each actor (or worker) in turn")
+            ("setup-threads",
+             po::value<size_t>()->default_value(0),
+             "Number of threads to construct actors on. Defaults to one per core.")
+            ("perf-counters",
+             po::value<bool>()->default_value(false)->implicit_value(true),
+             "Record CPU cycles, instructions, cache misses and context switches of each actor "
+             "thread per phase and per --perf-counters-window. Counters the kernel won't give "
+             "access to are left blank.")
+            ("perf-counters-window",
+             po::value<int64_t>()->default_value(1000),
+             "For --perf-counters: milliseconds between samples")
+            ("coordinator",
+             po::value<std::string>()->default_value("localhost:9955"),
+             "For coordinate and work: host:port the coordinator listens on")
+            ("processes",
+             po::value<size_t>()->default_value(1),
+             "For coordinate: number of worker processes to wait for")
+            ("saturate-phase",
+             po::value<PhaseNumber>()->default_value(0),
+             "For saturate: the phase to run at different rates. "
+             "Other phases only run in the first trial.")
+            ("saturate-latency",
+             po::value<std::string>(),
+             "For saturate: the latency SLO, e.g. '10 milliseconds'")
+            ("saturate-percentile",
+             po::value<double>()->default_value(99),
+             "For saturate: the latency percentile the SLO applies to")
+            ("saturate-min-rate",
+             po::value<int64_t>()->default_value(1),
+             "For saturate: lowest rate to try, in iterations per second")
+            ("saturate-max-rate",
+             po::value<int64_t>()->default_value(100000),
+             "For saturate: highest rate to try, in iterations per second")
+            ("saturate-trials",
+             po::value<int64_t>()->default_value(10),
+             "For saturate: maximum number of times to run the phase")
+            ("sweep",
+             po::value<std::vector<std::string>>()->composing(),
+             "For sweep: a ^Parameter and the values to run it at, e.g. 'Threads=1,2,4,8'. "
+             "Can be given several times to sweep every combination.")
+            ("sweep-phase",
+             po::value<PhaseNumber>(),
+             "For sweep: only measure this phase and only run the other phases for the first "
+             "point, e.g. to load data once");
 
     positional.add("subcommand", 1);
     positional.add("workload-file", -1);
@@ -330,6 +862,16 @@ DefaultDriver::ProgramOptions::ProgramOptions(int argc, char** argv) {
         this->runMode = RunMode::kEvaluate;
     else if (subcommand == "run")
         this->runMode = RunMode::kNormal;
+    else if (subcommand == "saturate")
+        this->runMode = RunMode::kSaturate;
+    else if (subcommand == "sweep")
+        this->runMode = RunMode::kSweep;
+    else if (subcommand == "coordinate")
+        this->runMode = RunMode::kCoordinate;
+    else if (subcommand == "work")
+        this->runMode = RunMode::kWork;
+    else if (subcommand == "compile")
+        this->runMode = RunMode::kCompile;
     else if (subcommand == "help")
         this->runMode = RunMode::kHelp;
     else {
@@ -347,11 +889,59 @@ DefaultDriver::ProgramOptions::ProgramOptions(int argc, char** argv) {
     this->metricsOutputFileName = normalizeOutputFile(vm["metrics-output-file"].as<std::string>());
     this->mongoUri = vm["mongo-uri"].as<std::string>();
 
+    const auto execution = vm["execution"].as<std::string>();
+    if (execution == "threads") {
+        this->execution = Execution::kThreads;
+    } else if (execution == "fibers") {
+        this->execution = Execution::kFibers;
+    } else {
+        throw std::invalid_argument("Invalid execution '" + execution +
+                                    "'. Valid values are threads/fibers.");
+    }
+    this->workers = vm["workers"].as<size_t>();
+    this->cpuAffinity = vm["cpu-affinity"].as<std::string>();
+    this->setupThreads = vm["setup-threads"].as<size_t>();
+    this->perfCounters = vm["perf-counters"].as<bool>();
+    this->perfCountersWindow = std::chrono::milliseconds{vm["perf-counters-window"].as<int64_t>()};
+    this->coordinator = vm["coordinator"].as<std::string>();
+    this->processes = vm["processes"].as<size_t>();
+
+    this->saturation.phase = vm["saturate-phase"].as<PhaseNumber>();
+    if (vm.count("saturate-latency") > 0) {
+        this->saturation.latency = vm["saturate-latency"].as<std::string>();
+    }
+    this->saturation.percentile = vm["saturate-percentile"].as<double>();
+    this->saturation.minRate = vm["saturate-min-rate"].as<int64_t>();
+    this->saturation.maxRate = vm["saturate-max-rate"].as<int64_t>();
+    this->saturation.maxTrials = vm["saturate-trials"].as<int64_t>();
+
+    if (vm.count("sweep") > 0) {
+        this->sweep.parameters = vm["sweep"].as<std::vector<std::string>>();
+    }
+    if (vm.count("sweep-phase") > 0) {
+        this->sweep.phase = vm["sweep-phase"].as<PhaseNumber>();
+    }
+
     if (vm.count("workload-file") > 0) {
         this->workloadSource = vm["workload-file"].as<std::string>();
         this->workloadSourceType = YamlSource::kFile;
     } else {
         this->workloadSourceType = YamlSource::kString;
     }
+
+    if (this->runMode == RunMode::kCompile) {
+        if (this->isSmokeTest) {
+            // Compiled workloads are smoke-tested when they're run instead.
+            throw std::invalid_argument(
+                "Can't compile in smoke test mode. Use --smoke-test when running the "
+                "compiled workload instead.");
+        }
+        if (!vm["metrics-output-file"].defaulted()) {
+            this->compiledWorkloadFileName = this->metricsOutputFileName;
+        } else {
+            this->compiledWorkloadFileName =
+                fs::path(this->workloadSource).replace_extension(".gwc").string();
+        }
+    }
 }
 }  // namespace genny::driver
@@ -0,0 +1,83 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/FiberPool.hpp>
+
+#include <mutex>
+#include <thread>
+
+#include <boost/fiber/algo/shared_work.hpp>
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/fiber.hpp>
+#include <boost/fiber/mutex.hpp>
+#include <boost/fiber/operations.hpp>
+#include <boost/fiber/protected_fixedsize_stack.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+namespace genny::driver::v1 {
+
+void runOnFibers(const std::vector<std::function<void()>>& tasks,
+                 size_t workers,
+                 const std::function<void(size_t)>& onWorkerStart,
+                 size_t stackSize) {
+    if (workers == 0) {
+        throw InvalidConfigurationException("Need at least one worker thread to run fibers");
+    }
+
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable allFinished;
+    size_t remaining = tasks.size();
+
+    auto worker = [&](size_t index) {
+        if (onWorkerStart) {
+            onWorkerStart(index);
+        }
+
+        // The shared_work algorithm keeps a single process-wide queue of ready fibers that
+        // all workers pull from. Passing `true` lets idle workers sleep rather than spin.
+        boost::fibers::use_scheduling_algorithm<boost::fibers::algo::shared_work>(true);
+
+        if (index == 0) {
+            for (const auto& task : tasks) {
+                boost::fibers::fiber{std::allocator_arg,
+                                     boost::fibers::protected_fixedsize_stack{stackSize},
+                                     [&]() {
+                                         task();
+
+                                         std::unique_lock<boost::fibers::mutex> lk{mutex};
+                                         if (--remaining == 0) {
+                                             allFinished.notify_all();
+                                         }
+                                     }}
+                    .detach();
+            }
+        }
+
+        // Suspends this thread's main fiber so the worker can run others in the meantime.
+        std::unique_lock<boost::fibers::mutex> lk{mutex};
+        allFinished.wait(lk, [&]() { return remaining == 0; });
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace genny::driver::v1
@@ -0,0 +1,129 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/ParameterSweep.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+namespace genny::driver::v1 {
+
+namespace {
+
+std::vector<std::string> splitValues(const std::string& values) {
+    std::vector<std::string> out;
+    std::istringstream in{values};
+    std::string value;
+    while (std::getline(in, value, ',')) {
+        out.push_back(value);
+    }
+    return out;
+}
+
+}  // namespace
+
+YamlParameters SweepPoint::parameters() const {
+    YamlParameters out;
+    for (const auto& [name, value] : values) {
+        // Let YAML decide whether it's a number, a string etc. as if written in the workload.
+        out[name] = YAML::Load(value);
+    }
+    return out;
+}
+
+ParameterSweep::ParameterSweep(const std::vector<std::string>& specs) {
+    if (specs.empty()) {
+        throw InvalidConfigurationException("Need at least one parameter to sweep");
+    }
+
+    std::vector<std::vector<std::string>> values;
+    for (const auto& spec : specs) {
+        const auto equals = spec.find('=');
+        if (equals == 0 || equals == std::string::npos || equals + 1 == spec.size()) {
+            throw InvalidConfigurationException(
+                "Sweep parameters must be Name=value1,value2,... Gave '" + spec + "'");
+        }
+        const auto name = spec.substr(0, equals);
+        if (std::find(_names.begin(), _names.end(), name) != _names.end()) {
+            throw InvalidConfigurationException("Sweep parameter '" + name + "' given twice");
+        }
+        _names.push_back(name);
+        values.push_back(splitValues(spec.substr(equals + 1)));
+    }
+
+    // Count through the combinations like an odometer with the last parameter
+    // as the lowest digit.
+    std::vector<size_t> digits(values.size(), 0);
+    while (true) {
+        SweepPoint point;
+        for (size_t i = 0; i < values.size(); ++i) {
+            point.values.emplace_back(_names[i], values[i][digits[i]]);
+        }
+        _points.push_back(std::move(point));
+
+        auto i = values.size();
+        while (i > 0 && ++digits[i - 1] == values[i - 1].size()) {
+            digits[i - 1] = 0;
+            --i;
+        }
+        if (i == 0) {
+            break;
+        }
+    }
+}
+
+void ParameterSweep::checkParameters(const std::set<std::string>& read) const {
+    for (const auto& name : _names) {
+        if (read.count(name) == 0) {
+            throw InvalidConfigurationException("Sweep parameter '" + name +
+                                                "' isn't a ^Parameter of the workload");
+        }
+    }
+}
+
+void ParameterSweep::record(const SweepResult& result) {
+    if (_results.size() >= _points.size()) {
+        throw std::logic_error("Recorded more sweep results than there are points");
+    }
+    _results.push_back(result);
+}
+
+void ParameterSweep::report(std::ostream& out) const {
+    out << "ParameterSweep" << std::endl;
+    out << "point,";
+    for (const auto& name : _names) {
+        out << name << ",";
+    }
+    out << "outcome,iterations,operations,duration,iterations_per_second,p50,p99" << std::endl;
+
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const auto& result = _results[i];
+        out << i << ",";
+        for (const auto& [name, value] : _points[i].values) {
+            out << value << ",";
+        }
+        out << static_cast<int>(result.outcome) << ",";
+        out << result.iterations << ",";
+        out << result.operations << ",";
+        out << result.duration.count() << ",";
+        out << result.throughput << ",";
+        out << result.p50.count() << ",";
+        out << result.p99.count() << std::endl;
+    }
+    out << std::endl;
+}
+
+}  // namespace genny::driver::v1
@@ -0,0 +1,191 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/PerfCounters.hpp>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <boost/log/trivial.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+struct Event {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+// In the same order as the fields of PerfReading.
+constexpr std::array<Event, 4> kEvents{{
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+}};
+
+int openEvent(const Event& event, bool excludeKernel) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.exclude_kernel = excludeKernel;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0 and cpu -1 count the calling thread on whichever CPU it runs.
+    return static_cast<int>(
+        ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::optional<int64_t> readEvent(int fd) {
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    uint64_t values[3];
+    if (::read(fd, values, sizeof(values)) != sizeof(values)) {
+        return std::nullopt;
+    }
+    const auto [value, enabled, running] = values;
+    if (running == 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(double(value) * double(enabled) / double(running));
+}
+
+std::optional<int64_t> delta(const std::optional<int64_t>& now,
+                             const std::optional<int64_t>& last) {
+    if (!now) {
+        return std::nullopt;
+    }
+    return *now - last.value_or(0);
+}
+
+}  // namespace
+
+ThreadPerfCounters::ThreadPerfCounters() {
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+        // Counting in the kernel too is more accurate (and needed for context switches) but
+        // perf_event_paranoid >= 2 only allows counting user-space.
+        _fds[i] = openEvent(kEvents[i], false);
+        if (_fds[i] < 0 && (errno == EACCES || errno == EPERM)) {
+            _fds[i] = openEvent(kEvents[i], true);
+        }
+        if (_fds[i] < 0) {
+            _errors[kEvents[i].name] = std::strerror(errno);
+        }
+    }
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {
+    for (auto fd : _fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+bool ThreadPerfCounters::any() const {
+    return _errors.size() < kEvents.size();
+}
+
+PerfReading ThreadPerfCounters::read() const {
+    return {readEvent(_fds[0]), readEvent(_fds[1]), readEvent(_fds[2]), readEvent(_fds[3])};
+}
+
+PerfCounterSampler::PerfCounterSampler(metrics::Registry& registry,
+                                       std::chrono::milliseconds window)
+    : _registry{registry} {
+    _sampler = std::thread([this, window]() {
+        std::unique_lock<std::mutex> lk{_mutex};
+        while (!_stop.wait_for(lk, window, [&]() { return _stopping; })) {
+            sampleAll();
+        }
+    });
+}
+
+PerfCounterSampler::~PerfCounterSampler() {
+    {
+        std::lock_guard<std::mutex> lk{_mutex};
+        _stopping = true;
+    }
+    _stop.notify_all();
+    _sampler.join();
+}
+
+void PerfCounterSampler::attachCurrentThread(ActorId actorId) {
+    auto counters = std::make_unique<ThreadPerfCounters>();
+    auto start = counters->read();
+
+    std::lock_guard<std::mutex> lk{_mutex};
+    if (!counters->errors().empty() && !_warned) {
+        _warned = true;
+        for (const auto& [name, error] : counters->errors()) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Can't count " << name << " for --perf-counters: " << error
+                << ". Check /proc/sys/kernel/perf_event_paranoid and that the machine (or VM) "
+                   "exposes hardware performance counters.";
+        }
+    }
+    if (!counters->any()) {
+        return;
+    }
+    _attached[actorId] = Attached{std::move(counters), std::move(start)};
+}
+
+void PerfCounterSampler::detach(ActorId actorId) {
+    std::lock_guard<std::mutex> lk{_mutex};
+    auto it = _attached.find(actorId);
+    if (it == _attached.end()) {
+        return;
+    }
+    record(actorId, it->second, metrics::clock::now());
+    _attached.erase(it);
+}
+
+void PerfCounterSampler::phaseStarting(PhaseNumber phase) {
+    std::lock_guard<std::mutex> lk{_mutex};
+    sampleAll();
+    _phase = phase;
+}
+
+void PerfCounterSampler::sample() {
+    std::lock_guard<std::mutex> lk{_mutex};
+    sampleAll();
+}
+
+void PerfCounterSampler::sampleAll() {
+    const auto now = metrics::clock::now();
+    for (auto& [actorId, attached] : _attached) {
+        record(actorId, attached, now);
+    }
+}
+
+void PerfCounterSampler::record(ActorId actorId, Attached& attached, metrics::time_point now) {
+    auto reading = attached.counters->read();
+    _registry.recordPerfSample({now,
+                                actorId,
+                                _phase,
+                                delta(reading.cycles, attached.last.cycles),
+                                delta(reading.instructions, attached.last.instructions),
+                                delta(reading.cacheMisses, attached.last.cacheMisses),
+                                delta(reading.contextSwitches, attached.last.contextSwitches)});
+    attached.last = std::move(reading);
+}
+
+}  // namespace genny::driver::v1
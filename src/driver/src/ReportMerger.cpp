@@ -0,0 +1,273 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/ReportMerger.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace genny::driver::v1 {
+namespace {
+
+// A titled block of lines. Sections are separated by blank lines.
+struct Section {
+    std::string name;
+    std::vector<std::string> lines;
+};
+
+struct Report {
+    std::vector<Section> sections;
+    // Added to timestamps to move them onto the first report's metrics clock.
+    int64_t clockOffset = 0;
+    // Added to actor ids so they don't collide with those of earlier reports.
+    int64_t idOffset = 0;
+};
+
+// Marks the actor id in legacy csv metric names like `InsertRemove.id-3.insert_timer`.
+constexpr auto kLegacyIdMarker = ".id-";
+constexpr auto kActiveActors = "Genny.ActiveActors";
+
+std::vector<Section> parseSections(const std::string& report) {
+    std::vector<Section> out;
+    std::istringstream in{report};
+    std::string line;
+    bool inSection = false;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            inSection = false;
+        } else if (!inSection) {
+            out.push_back({line, {}});
+            inSection = true;
+        } else {
+            out.back().lines.push_back(line);
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> out;
+    std::istringstream in{line};
+    std::string field;
+    while (std::getline(in, field, ',')) {
+        out.push_back(field);
+    }
+    return out;
+}
+
+std::string join(const std::vector<std::string>& fields) {
+    std::string out;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            out += ",";
+        }
+        out += fields[i];
+    }
+    return out;
+}
+
+std::string shifted(const std::string& number, int64_t offset) {
+    return std::to_string(int64_t{std::stoll(number)} + offset);
+}
+
+const Section* findSection(const Report& report, const std::string& name) {
+    for (const auto& section : report.sections) {
+        if (section.name == name) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+// Whether a section's first line names its columns.
+bool hasColumnNames(const std::string& section) {
+    return section == "Placement" || section == "OperationThreadCounts" ||
+        section == "Operations";
+}
+
+// @return the position of the id in a legacy metric name and its length.
+std::optional<std::pair<size_t, size_t>> findLegacyId(const std::string& name) {
+    const auto marker = name.find(kLegacyIdMarker);
+    if (marker == std::string::npos) {
+        return std::nullopt;
+    }
+    const auto start = marker + std::string{kLegacyIdMarker}.size();
+    const auto end = name.find('.', start);
+    return std::make_pair(start, (end == std::string::npos ? name.size() : end) - start);
+}
+
+// Calls `f` with every actor id mentioned in a section and lets it replace the id.
+template <typename F>
+void forEachActorId(Section& section, F&& f) {
+    const bool skipColumnNames = hasColumnNames(section.name);
+    for (size_t i = skipColumnNames ? 1 : 0; i < section.lines.size(); ++i) {
+        auto fields = split(section.lines[i]);
+        if (section.name == "Placement" && fields.size() > 0) {
+            fields[0] = f(fields[0]);
+        } else if (section.name == "Operations" && fields.size() > 2 && fields[1] != "Genny") {
+            fields[2] = f(fields[2]);
+        } else if ((section.name == "Counters" || section.name == "Timers") &&
+                   fields.size() > 1) {
+            if (auto id = findLegacyId(fields[1])) {
+                const auto& [start, length] = *id;
+                fields[1].replace(start, length, f(fields[1].substr(start, length)));
+            }
+        } else {
+            continue;
+        }
+        section.lines[i] = join(fields);
+    }
+}
+
+int64_t clockOffset(const Report& report) {
+    const auto* clocks = findSection(report, "Clocks");
+    if (!clocks) {
+        throw std::invalid_argument("Metrics report has no Clocks section");
+    }
+    std::optional<int64_t> systemTime;
+    std::optional<int64_t> metricsTime;
+    for (const auto& line : clocks->lines) {
+        const auto fields = split(line);
+        if (fields.size() == 2 && fields[0] == "SystemTime") {
+            systemTime = std::stoll(fields[1]);
+        } else if (fields.size() == 2 && fields[0] == "MetricsTime") {
+            metricsTime = std::stoll(fields[1]);
+        }
+    }
+    if (!systemTime || !metricsTime) {
+        throw std::invalid_argument("Metrics report has incomplete Clocks section");
+    }
+    return *systemTime - *metricsTime;
+}
+
+void writeSection(std::ostream& out, const std::string& name, std::vector<Report>& reports) {
+    out << name << std::endl;
+
+    if (name == "Clocks") {
+        for (const auto& line : findSection(reports.front(), name)->lines) {
+            out << line << std::endl;
+        }
+        out << std::endl;
+        return;
+    }
+
+    const bool withColumnNames = hasColumnNames(name);
+    bool wroteColumnNames = false;
+
+    // OperationThreadCounts: (actor, operation) -> workers.
+    std::map<std::pair<std::string, std::string>, int64_t> threadCounts;
+    // Genny.ActiveActors: timestamp -> change in the number of active actors.
+    std::multimap<int64_t, int64_t> activeActorChanges;
+    std::vector<std::string> rows;
+
+    for (auto& report : reports) {
+        for (const auto& section : report.sections) {
+            if (section.name != name) {
+                continue;
+            }
+            size_t i = 0;
+            if (withColumnNames && !section.lines.empty()) {
+                if (!wroteColumnNames) {
+                    out << section.lines.front() << std::endl;
+                    wroteColumnNames = true;
+                }
+                i = 1;
+            }
+
+            int64_t activeActors = 0;
+            for (; i < section.lines.size(); ++i) {
+                auto fields = split(section.lines[i]);
+                if (name == "OperationThreadCounts" && fields.size() == 3) {
+                    threadCounts[{fields[0], fields[1]}] += std::stoll(fields[2]);
+                    continue;
+                }
+                if ((name == "Counters" || name == "Timers" || name == "Operations") &&
+                    !fields.empty()) {
+                    fields[0] = shifted(fields[0], report.clockOffset);
+                }
+                if (name == "Counters" && fields.size() == 3 && fields[1] == kActiveActors) {
+                    const auto count = std::stoll(fields[2]);
+                    activeActorChanges.emplace(std::stoll(fields[0]), count - activeActors);
+                    activeActors = count;
+                    continue;
+                }
+                rows.push_back(join(fields));
+            }
+        }
+    }
+
+    for (const auto& [key, count] : threadCounts) {
+        out << key.first << "," << key.second << "," << count << std::endl;
+    }
+    int64_t activeActors = 0;
+    for (const auto& [when, change] : activeActorChanges) {
+        activeActors += change;
+        out << when << "," << kActiveActors << "," << activeActors << std::endl;
+    }
+    for (const auto& row : rows) {
+        out << row << std::endl;
+    }
+    out << std::endl;
+}
+
+}  // namespace
+
+
+void mergeReports(const std::vector<std::string>& reportStrings, std::ostream& out) {
+    if (reportStrings.empty()) {
+        throw std::invalid_argument("Need at least one metrics report to merge");
+    }
+
+    std::vector<Report> reports;
+    for (const auto& str : reportStrings) {
+        reports.push_back({parseSections(str)});
+    }
+
+    const auto firstOffset = clockOffset(reports.front());
+    int64_t nextId = 0;
+    for (auto& report : reports) {
+        report.clockOffset = clockOffset(report) - firstOffset;
+        report.idOffset = nextId;
+
+        int64_t maxId = -1;
+        for (auto& section : report.sections) {
+            forEachActorId(section, [&](const std::string& id) {
+                const int64_t renumbered = std::stoll(id) + report.idOffset;
+                maxId = std::max(maxId, renumbered);
+                return std::to_string(renumbered);
+            });
+        }
+        nextId = std::max(nextId, maxId + 1);
+    }
+
+    // Keep sections in the order the reports have them.
+    std::vector<std::string> names;
+    for (const auto& report : reports) {
+        for (const auto& section : report.sections) {
+            if (std::find(names.begin(), names.end(), section.name) == names.end()) {
+                names.push_back(section.name);
+            }
+        }
+    }
+    for (const auto& name : names) {
+        writeSection(out, name, reports);
+    }
+}
+
+}  // namespace genny::driver::v1
@@ -0,0 +1,138 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <driver/v1/SaturationSearch.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+#include <gennylib/conventions.hpp>
+
+#include <driver/workload_parsers.hpp>
+
+namespace genny::driver::v1 {
+
+namespace {
+
+// Stop bisecting once the bounds are within 1% of each other.
+constexpr int64_t kTolerancePercent = 1;
+
+// Name of the rate-limiter shared by every Actor in the search phase.
+constexpr auto kRateLimiterName = "SaturationSearch";
+
+}  // namespace
+
+SaturationSearch::SaturationSearch(int64_t minRate, int64_t maxRate, int64_t maxTrials)
+    : _minRate{minRate}, _maxRate{maxRate}, _maxTrials{maxTrials} {
+    if (minRate <= 0 || maxRate < minRate) {
+        std::ostringstream msg;
+        msg << "Saturation search needs 0 < min-rate <= max-rate. Gave min-rate " << minRate
+            << " and max-rate " << maxRate;
+        throw InvalidConfigurationException(msg.str());
+    }
+    if (maxTrials <= 0) {
+        throw InvalidConfigurationException("Saturation search needs at least one trial");
+    }
+}
+
+std::optional<int64_t> SaturationSearch::nextRate() const {
+    if (_trajectory.size() >= static_cast<size_t>(_maxTrials)) {
+        return std::nullopt;
+    }
+    if (_trajectory.empty()) {
+        return _minRate;
+    }
+    if (!_highestPassing) {
+        // Can't meet the SLO even at the lowest rate.
+        return std::nullopt;
+    }
+    if (!_lowestFailing) {
+        // Everything tried so far passes: check the upper bound.
+        return *_highestPassing < _maxRate ? std::make_optional(_maxRate) : std::nullopt;
+    }
+
+    const auto low = *_highestPassing;
+    const auto high = *_lowestFailing;
+    // Either converged or the measurements were too noisy to bisect any further
+    // (a lower rate failed after a higher one passed).
+    if (high - low <= std::max<int64_t>(1, low * kTolerancePercent / 100)) {
+        return std::nullopt;
+    }
+    return low + (high - low) / 2;
+}
+
+void SaturationSearch::record(const SaturationTrial& trial) {
+    _trajectory.push_back(trial);
+    if (trial.meetsSlo) {
+        _highestPassing = std::max(_highestPassing.value_or(trial.rate), trial.rate);
+    } else {
+        _lowestFailing = std::min(_lowestFailing.value_or(trial.rate), trial.rate);
+    }
+}
+
+void SaturationSearch::report(std::ostream& out) const {
+    out << "SaturationSearch" << std::endl;
+    out << "trial,rate,iterations_per_second,latency,meets_slo" << std::endl;
+    for (size_t i = 0; i < _trajectory.size(); ++i) {
+        const auto& trial = _trajectory[i];
+        out << i << ",";
+        out << trial.rate << ",";
+        out << trial.throughput << ",";
+        out << trial.latency.count() << ",";
+        out << trial.meetsSlo << std::endl;
+    }
+    out << std::endl;
+
+    out << "SaturationResult" << std::endl;
+    out << "max_sustainable_rate" << std::endl;
+    if (_highestPassing) {
+        out << *_highestPassing << std::endl;
+    } else {
+        out << "none" << std::endl;
+    }
+}
+
+YAML::Node SaturationSearch::configureTrial(const YAML::Node& workload,
+                                            PhaseNumber phase,
+                                            int64_t rate,
+                                            bool onlySearchPhase) {
+    auto out =
+        onlySearchPhase ? OnlyPhaseConverter::convert(workload, phase) : YAML::Clone(workload);
+
+    // Express the rate as one operation per interval; a burst size of 1 keeps the
+    // rate-limiter well-behaved regardless of how many threads share it.
+    std::ostringstream globalRate;
+    globalRate << "1 per " << std::max<int64_t>(1, 1000 * 1000 * 1000 / rate) << " nanoseconds";
+
+    for (auto actor : out["Actors"]) {
+        auto phases = actor["Phases"];
+        if (!phases.IsSequence()) {
+            continue;
+        }
+        const auto ranges = phaseRanges(phases);
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            auto block = phases[i];
+            const bool isSearchPhase = ranges[i].start <= phase && phase <= ranges[i].end;
+            const bool isNop = block["Nop"] && block["Nop"].as<bool>();
+            if (isSearchPhase && !isNop && (block["Duration"] || block["Repeat"])) {
+                block["GlobalRate"] = globalRate.str();
+                block["RateLimiterName"] = kRateLimiterName;
+            }
+        }
+    }
+    return out;
+}
+
+}  // namespace genny::driver::v1
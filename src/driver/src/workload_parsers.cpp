@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <optional>
+
 #include <boost/log/trivial.hpp>
 
 #include <driver/workload_parsers.hpp>
@@ -82,6 +84,7 @@ YAML::Node WorkloadParser::replaceParam(YAML::Node input) {
     }
 
     auto name = input["Name"].as<std::string>();
+    _parameterNames.insert(name);
     // The default value is mandatory.
     auto defaultVal = input["Default"];
 
@@ -188,7 +191,8 @@ YAML::Node convertObjForSmokeTest(YAML::Node inNode) {
         auto&& value = kvp.second;
         if (key == "Duration" || key == "Repeat") {
             out["Repeat"] = 1;
-        } else if (key == "GlobalRate" || key == "SleepBefore" || key == "SleepAfter") {
+        } else if (key == "GlobalRate" || key == "SleepBefore" || key == "SleepAfter" ||
+                   key == "Warmup" || key == "Cooldown" || key == "EarlyStop") {
             // Ignore those keys in smoke tests.
         } else {
             out[key] = value;
@@ -219,4 +223,60 @@ YAML::Node SmokeTestConverter::convert(YAML::Node workloadRoot) {
 
     return workloadRoot;
 }
+
+std::vector<PhaseRangeSpec> phaseRanges(const YAML::Node& phases) {
+    std::vector<PhaseRangeSpec> out;
+    PhaseNumbering numbering;
+    for (const auto& block : phases) {
+        out.push_back(numbering.next(block["Phase"]
+                                         ? std::make_optional(block["Phase"].as<PhaseRangeSpec>())
+                                         : std::nullopt));
+    }
+    return out;
+}
+
+namespace {
+
+YAML::Node nopBlock(const YAML::Node& block, PhaseNumber start, PhaseNumber end) {
+    YAML::Node out;
+    out["Phase"] = start == end ? YAML::Node{start} : YAML::Node{PhaseRangeSpec{start, end}};
+    out["Nop"] = true;
+    if (block["Threads"]) {
+        out["Threads"] = YAML::Clone(block["Threads"]);
+    }
+    return out;
+}
+
+}  // namespace
+
+YAML::Node OnlyPhaseConverter::convert(const YAML::Node& workloadRoot, PhaseNumber phase) {
+    auto out = YAML::Clone(workloadRoot);
+    for (auto actor : out["Actors"]) {
+        const auto phases = actor["Phases"];
+        if (!phases.IsSequence()) {
+            continue;
+        }
+        const auto ranges = phaseRanges(phases);
+        YAML::Node phasesOut{YAML::NodeType::Sequence};
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            const auto block = phases[i];
+            const auto& range = ranges[i];
+            if (phase < range.start || range.end < phase) {
+                phasesOut.push_back(nopBlock(block, range.start, range.end));
+                continue;
+            }
+            if (range.start < phase) {
+                phasesOut.push_back(nopBlock(block, range.start, phase - 1));
+            }
+            auto kept = YAML::Clone(block);
+            kept["Phase"] = phase;
+            phasesOut.push_back(kept);
+            if (phase < range.end) {
+                phasesOut.push_back(nopBlock(block, phase + 1, range.end));
+            }
+        }
+        actor["Phases"] = phasesOut;
+    }
+    return out;
+}
 }  // namespace genny::driver::v1
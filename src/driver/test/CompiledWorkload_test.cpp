@@ -0,0 +1,151 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include <driver/v1/CompiledWorkload.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using Catch::Matchers::StartsWith;
+
+const auto kWorkload = YAML::Load(R"(
+SchemaVersion: 2018-07-01
+Database: &db test
+Actors:
+- Name: Inserter
+  Type: CrudActor
+  Threads: 100
+  Database: *db
+  Phases:
+  - Repeat: 1000
+    Document: {a: {^RandomInt: {min: 0, max: 10}}, b: "123", c: ~, d: [], e: {}}
+  - Nop: true
+- Name: Remover
+  Type: CrudActor
+  Phases:
+  - Repeat: 1000
+    Quoted: 'single'
+)");
+
+// Like comparing YAML::Dump output but ignoring flow style and anchors.
+bool same(const YAML::Node& lhs, const YAML::Node& rhs) {
+    if (lhs.Type() != rhs.Type() || lhs.Tag() != rhs.Tag() || lhs.size() != rhs.size()) {
+        return false;
+    }
+    if (lhs.IsScalar()) {
+        return lhs.Scalar() == rhs.Scalar();
+    }
+    if (lhs.IsSequence()) {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (!same(lhs[i], rhs[i])) {
+                return false;
+            }
+        }
+    }
+    if (lhs.IsMap()) {
+        for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end(); ++l, ++r) {
+            if (!same(l->first, r->first) || !same(l->second, r->second)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string compile(const YAML::Node& yaml) {
+    std::ostringstream out;
+    CompiledWorkload::write(yaml, out);
+    return out.str();
+}
+
+TEST_CASE("Compiled workloads read back the same") {
+    const auto bytes = compile(kWorkload);
+    const auto read = CompiledWorkload::read(bytes);
+
+    REQUIRE(same(read, kWorkload));
+
+    // Quoted scalars are tagged "!" which DocumentGenerator relies on to keep them strings.
+    const auto document = read["Actors"][0]["Phases"][0]["Document"];
+    REQUIRE(document["b"].Tag() == "!");
+    REQUIRE(document["a"]["^RandomInt"]["max"].as<int>() == 10);
+    REQUIRE(document["c"].IsNull());
+    REQUIRE(document["d"].IsSequence());
+    REQUIRE(document["e"].IsMap());
+    REQUIRE(read["Actors"][1]["Database"].IsDefined() == false);
+
+    SECTION("Repeated strings are stored once") {
+        const auto longString = std::string(1000, 'x');
+        YAML::Node many;
+        for (int i = 0; i < 100; ++i) {
+            many.push_back(longString);
+        }
+        REQUIRE(compile(many).size() < 2 * longString.size());
+    }
+
+    SECTION("Loading from a file") {
+        const auto path =
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        {
+            std::ofstream out{path.string(), std::ios::binary};
+            out << bytes;
+        }
+        REQUIRE(CompiledWorkload::isCompiled(path.string()));
+        REQUIRE(same(CompiledWorkload::load(path.string()), kWorkload));
+        boost::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("Compiled workloads are checked when read") {
+    const auto bytes = compile(kWorkload);
+
+    SECTION("Plain YAML") {
+        REQUIRE_THROWS_WITH(CompiledWorkload::read("SchemaVersion: 2018-07-01"),
+                            "Not a compiled workload");
+    }
+
+    SECTION("Another format version") {
+        auto other = bytes;
+        other[8] = 99;
+        REQUIRE_THROWS_WITH(CompiledWorkload::read(other),
+                            StartsWith("Compiled workload has format version 99"));
+    }
+
+    SECTION("Truncated") {
+        REQUIRE_THROWS_AS(CompiledWorkload::read(std::string_view{bytes}.substr(0, 100)),
+                          InvalidConfigurationException);
+    }
+
+    SECTION("Trailing bytes") {
+        REQUIRE_THROWS_AS(CompiledWorkload::read(bytes + "x"), InvalidConfigurationException);
+    }
+
+    SECTION("Missing file") {
+        REQUIRE(!CompiledWorkload::isCompiled("/does/not/exist.gwc"));
+        REQUIRE_THROWS_AS(CompiledWorkload::load("/does/not/exist.gwc"),
+                          InvalidConfigurationException);
+    }
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
@@ -0,0 +1,206 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <boost/asio/write.hpp>
+
+#include <driver/v1/Coordinator.hpp>
+
+#include <gennylib/conventions.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+std::mutex asserting;
+
+TEST_CASE("Coordinator splits the workload between workers") {
+    auto yaml = YAML::Load(R"(
+    SchemaVersion: 2018-07-01
+    Actors:
+    - Name: Five
+      Type: Five
+      Threads: 5
+      Phases:
+      - Repeat: 10
+        GlobalRate: 30 per 1 second
+      - Repeat: 10
+        Threads: 2
+    - Name: One
+      Type: One
+      Phases:
+      - Repeat: 10
+    )");
+
+    auto threads = [](const YAML::Node& share, size_t actor) {
+        return share["Actors"][actor]["Threads"].as<int64_t>();
+    };
+
+    std::vector<YAML::Node> shares;
+    for (size_t i = 0; i < 3; ++i) {
+        shares.push_back(Coordinator::shareOf(yaml, i, 3));
+    }
+
+    // 5 threads: 2, 2, 1.
+    REQUIRE(threads(shares[0], 0) == 2);
+    REQUIRE(threads(shares[1], 0) == 2);
+    REQUIRE(threads(shares[2], 0) == 1);
+    REQUIRE(shares[0]["Actors"][0]["Phases"][1]["Threads"].as<int64_t>() == 1);
+    REQUIRE(shares[2]["Actors"][0]["Phases"][1]["Threads"].as<int64_t>() == 0);
+
+    // The second Actor's single thread goes to a different worker than the first's leftovers.
+    REQUIRE(threads(shares[0], 1) == 0);
+    REQUIRE(threads(shares[1], 1) == 1);
+    REQUIRE(threads(shares[2], 1) == 0);
+
+    // Rates add back up to 30 per second.
+    auto rate = [](const YAML::Node& share) {
+        return share["Actors"][0]["Phases"][0]["GlobalRate"].as<RateSpec>();
+    };
+    REQUIRE(rate(shares[0]) == RateSpec{2500 * 1000 * 1000L, 30});
+    REQUIRE(rate(shares[2]) == RateSpec{5000 * 1000 * 1000L, 30});
+
+    // The original is untouched.
+    REQUIRE(yaml["Actors"][0]["Threads"].as<int64_t>() == 5);
+}
+
+TEST_CASE("Coordinator splits named rate limiters once") {
+    // Both Actors use the same limiter, so between them the workers should run at 10 per
+    // second in total even though each Actor's only thread goes to a different worker.
+    auto yaml = YAML::Load(R"(
+    Actors:
+    - Name: A
+      Type: A
+      Phases:
+      - Repeat: 10
+        GlobalRate: 10 per 1 second
+        RateLimiterName: Shared
+    - Name: B
+      Type: B
+      Phases:
+      - Repeat: 10
+        GlobalRate: 10 per 1 second
+        RateLimiterName: Shared
+    )");
+
+    auto rate = [](const YAML::Node& share, size_t actor) {
+        return share["Actors"][actor]["Phases"][0]["GlobalRate"].as<RateSpec>();
+    };
+    for (size_t i = 0; i < 2; ++i) {
+        const auto share = Coordinator::shareOf(yaml, i, 2);
+        REQUIRE(share["Actors"][i]["Threads"].as<int64_t>() == 1);
+        REQUIRE(rate(share, i) == RateSpec{2000 * 1000 * 1000L, 10});
+    }
+}
+
+TEST_CASE("Coordinator keeps worker phases in step") {
+    Coordinator coordinator{"127.0.0.1:0", 2};
+    const auto address = "127.0.0.1:" + std::to_string(coordinator.port());
+
+    auto yaml = YAML::Load(R"(
+    Actors:
+    - Name: Two
+      Type: Two
+      Threads: 2
+    )");
+
+    std::atomic<int> started = 0;
+    std::vector<WorkerResult> results;
+    auto coordinating = std::thread([&]() { results = coordinator.run(yaml, "Test", "csv"); });
+
+    auto worker = [&](bool slow) {
+        CoordinatorClient client{address};
+        auto assignment = client.awaitAssignment();
+        {
+            std::lock_guard<std::mutex> lk{asserting};
+            REQUIRE(assignment.processes == 2);
+            REQUIRE(assignment.workloadName == "Test");
+            REQUIRE(assignment.metricsFormat == "csv");
+            REQUIRE(assignment.workload["Actors"][0]["Threads"].as<int>() == 1);
+        }
+        if (slow) {
+            std::this_thread::sleep_for(50ms);
+            std::lock_guard<std::mutex> lk{asserting};
+            // The other worker can't have started without us.
+            REQUIRE(started == 0);
+        }
+        client.awaitPhaseStart(0);
+        ++started;
+        client.awaitPhaseStart(1);
+        client.finish(DefaultDriver::OutcomeCode::kSuccess,
+                      "report " + std::to_string(assignment.index));
+    };
+    auto fast = std::thread(worker, false);
+    auto slow = std::thread(worker, true);
+
+    fast.join();
+    slow.join();
+    coordinating.join();
+
+    REQUIRE(started == 2);
+    REQUIRE(results.size() == 2);
+    for (size_t i = 0; i < results.size(); ++i) {
+        REQUIRE(results[i].outcome == DefaultDriver::OutcomeCode::kSuccess);
+        REQUIRE(results[i].report == "report " + std::to_string(i));
+    }
+}
+
+TEST_CASE("Coordinator stops waiting for lost workers") {
+    Coordinator coordinator{"127.0.0.1:0", 2};
+    const auto address = "127.0.0.1:" + std::to_string(coordinator.port());
+
+    std::vector<WorkerResult> results;
+    auto coordinating = std::thread(
+        [&]() { results = coordinator.run(YAML::Load("Actors: []"), "Test", "csv"); });
+
+    {
+        CoordinatorClient lost{address};
+        lost.awaitAssignment();
+    }
+    CoordinatorClient client{address};
+    client.awaitAssignment();
+    client.awaitPhaseStart(0);
+    client.finish(DefaultDriver::OutcomeCode::kSuccess, "");
+    coordinating.join();
+
+    REQUIRE(results[0].outcome == DefaultDriver::OutcomeCode::kInternalException);
+    REQUIRE(results[1].outcome == DefaultDriver::OutcomeCode::kSuccess);
+}
+
+TEST_CASE("Coordinator disconnects workers sending oversized messages") {
+    Coordinator coordinator{"127.0.0.1:0", 1};
+
+    std::vector<WorkerResult> results;
+    auto coordinating = std::thread(
+        [&]() { results = coordinator.run(YAML::Load("Actors: []"), "Test", "csv"); });
+
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::socket socket{io};
+    socket.connect({boost::asio::ip::make_address("127.0.0.1"), coordinator.port()});
+    // Without the limit the coordinator would wait for a payload that never comes.
+    const auto header = "DONE 0 " + std::to_string(Coordinator::kMaxPayloadSize + 1) + "\n";
+    boost::asio::write(socket, boost::asio::buffer(header));
+    coordinating.join();
+
+    REQUIRE(results[0].outcome == DefaultDriver::OutcomeCode::kInternalException);
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
@@ -0,0 +1,98 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <thread>
+
+#include <driver/v1/CpuAffinity.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+// Two NUMA nodes with interleaved CPU numbers like many 2-socket machines.
+const CpuTopology twoSockets = {
+    {0, 0}, {1, 1}, {2, 0}, {3, 1}, {4, 0}, {5, 1},
+};
+
+std::vector<int> cpus(const std::vector<CpuSlot>& slots) {
+    std::vector<int> out;
+    for (const auto& slot : slots) {
+        out.push_back(slot.cpu);
+    }
+    return out;
+}
+
+TEST_CASE("CPU lists") {
+    REQUIRE(parseCpuList("3") == std::vector<int>{3});
+    REQUIRE(parseCpuList("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    REQUIRE(parseCpuList(" 1, 2 ") == std::vector<int>{1, 2});
+    REQUIRE(parseCpuList("0-3\n") == std::vector<int>{0, 1, 2, 3});
+
+    REQUIRE_THROWS_AS(parseCpuList(""), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(parseCpuList("3-1"), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(parseCpuList("1-x"), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(parseCpuList("spreadd"), InvalidConfigurationException);
+}
+
+TEST_CASE("CpuAffinity placement") {
+    SECTION("none doesn't pin") {
+        REQUIRE(CpuAffinity{"none"}.plan(4, twoSockets).empty());
+    }
+
+    SECTION("compact fills one node first") {
+        REQUIRE(cpus(CpuAffinity{"compact"}.plan(4, twoSockets)) ==
+                std::vector<int>{0, 2, 4, 1});
+    }
+
+    SECTION("spread alternates nodes") {
+        REQUIRE(cpus(CpuAffinity{"spread"}.plan(4, twoSockets)) ==
+                std::vector<int>{0, 1, 2, 3});
+    }
+
+    SECTION("placement wraps around") {
+        REQUIRE(cpus(CpuAffinity{"compact"}.plan(8, twoSockets)) ==
+                std::vector<int>{0, 2, 4, 1, 3, 5, 0, 2});
+        REQUIRE(cpus(CpuAffinity{"spread"}.plan(8, twoSockets)) ==
+                std::vector<int>{0, 1, 2, 3, 4, 5, 0, 1});
+    }
+
+    SECTION("explicit lists give each actor's CPU") {
+        const auto plan = CpuAffinity{"5,0-1"}.plan(4, twoSockets);
+        REQUIRE(plan == std::vector<CpuSlot>{{5, 1}, {0, 0}, {1, 1}, {5, 1}});
+    }
+
+    SECTION("explicit CPUs must be available") {
+        REQUIRE_THROWS_AS(CpuAffinity{"6"}.plan(1, twoSockets), InvalidConfigurationException);
+    }
+}
+
+TEST_CASE("CPU topology") {
+    const auto topology = discoverCpuTopology();
+    REQUIRE(!topology.empty());
+
+    // Pinning to a CPU we're allowed to use works. Done on its own thread so the
+    // rest of the tests aren't pinned too.
+    CpuTopology pinned;
+    std::thread{[&]() {
+        CpuAffinity::pinCurrentThread(topology.front().cpu);
+        pinned = discoverCpuTopology();
+    }}.join();
+    REQUIRE(pinned == CpuTopology{topology.front()});
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
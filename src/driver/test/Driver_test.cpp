@@ -480,3 +480,10 @@ TEST_CASE("Various Actor Behaviors") {
         REQUIRE(!hasMetrics(opts));
     }
 }
+
+TEST_CASE("Workloads can't be compiled in smoke test mode") {
+    // Smoke-testing a compiled workload converts it when it's run.
+    const char* argv[] = {"genny", "compile", "--smoke-test", "workload.yml"};
+    REQUIRE_THROWS_AS(DefaultDriver::ProgramOptions(4, const_cast<char**>(argv)),
+                      std::invalid_argument);
+}
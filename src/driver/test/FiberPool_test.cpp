@@ -0,0 +1,93 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+
+#include <boost/fiber/operations.hpp>
+
+#include <driver/v1/FiberPool.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+#include <gennylib/Orchestrator.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+// Every task goes through `phases` phases in lock-step, sleeping in each one.
+void runPhases(size_t tasks, size_t workers, PhaseNumber phases) {
+    Orchestrator o{};
+    o.addRequiredTokens(int(tasks));
+    o.phasesAtLeastTo(phases - 1);
+
+    std::atomic<size_t> completedPhases = 0;
+    std::vector<std::function<void()>> fns(tasks, [&]() {
+        while (o.morePhases()) {
+            o.awaitPhaseStart();
+            boost::this_fiber::sleep_for(1ms);
+            ++completedPhases;
+            o.awaitPhaseEnd();
+        }
+    });
+
+    runOnFibers(fns, workers);
+    REQUIRE(completedPhases == tasks * phases);
+}
+
+TEST_CASE("Fibers run more actors than worker threads") {
+    SECTION("One worker") {
+        runPhases(1000, 1, 3);
+    }
+    SECTION("Several workers") {
+        runPhases(1000, 4, 3);
+    }
+    SECTION("More workers than tasks") {
+        runPhases(2, 4, 2);
+    }
+    SECTION("No tasks") {
+        runOnFibers({}, 2);
+    }
+    SECTION("Need a worker") {
+        REQUIRE_THROWS_AS(runOnFibers({[]() {}}, 0), InvalidConfigurationException);
+    }
+}
+
+TEST_CASE("Fibers and threads share an Orchestrator") {
+    Orchestrator o{};
+    o.addRequiredTokens(11);
+    o.phasesAtLeastTo(1);
+
+    std::atomic<int> completedPhases = 0;
+    auto body = [&]() {
+        while (o.morePhases()) {
+            o.awaitPhaseStart();
+            ++completedPhases;
+            o.awaitPhaseEnd();
+        }
+    };
+
+    // The plain thread has to wait for the fibers to reach each phase boundary.
+    std::thread thread{body};
+    runOnFibers(std::vector<std::function<void()>>(10, body), 2);
+    thread.join();
+
+    REQUIRE(completedPhases == 22);
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
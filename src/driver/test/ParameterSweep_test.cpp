@@ -0,0 +1,92 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <string>
+
+#include <driver/v1/ParameterSweep.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using namespace std::chrono_literals;
+
+std::vector<std::string> names(const SweepPoint& point) {
+    std::vector<std::string> out;
+    for (const auto& [name, value] : point.values) {
+        out.push_back(name + "=" + value);
+    }
+    return out;
+}
+
+TEST_CASE("ParameterSweep runs every combination") {
+    ParameterSweep sweep{{"Threads=1,2", "Size=small,large"}};
+    const auto& points = sweep.points();
+
+    REQUIRE(points.size() == 4);
+    REQUIRE(names(points[0]) == std::vector<std::string>{"Threads=1", "Size=small"});
+    REQUIRE(names(points[1]) == std::vector<std::string>{"Threads=1", "Size=large"});
+    REQUIRE(names(points[2]) == std::vector<std::string>{"Threads=2", "Size=small"});
+    REQUIRE(names(points[3]) == std::vector<std::string>{"Threads=2", "Size=large"});
+
+    SECTION("Values are typed like YAML") {
+        const auto params = points[3].parameters();
+        REQUIRE(params.at("Threads").as<int>() == 2);
+        REQUIRE(params.at("Size").as<std::string>() == "large");
+    }
+
+    SECTION("Single parameter") {
+        ParameterSweep single{{"Threads=1,2,4,8"}};
+        REQUIRE(single.points().size() == 4);
+        REQUIRE(names(single.points()[3]) == std::vector<std::string>{"Threads=8"});
+    }
+}
+
+TEST_CASE("ParameterSweep rejects malformed parameters") {
+    REQUIRE_THROWS_AS(ParameterSweep({}), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(ParameterSweep({"Threads"}), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(ParameterSweep({"=1,2"}), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(ParameterSweep({"Threads="}), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(ParameterSweep({"Threads=1", "Threads=2"}), InvalidConfigurationException);
+}
+
+TEST_CASE("ParameterSweep rejects parameters the workload doesn't read") {
+    ParameterSweep sweep{{"Threads=1,2", "Size=small,large"}};
+    REQUIRE_NOTHROW(sweep.checkParameters({"Threads", "Size", "Repeat"}));
+    REQUIRE_THROWS_AS(sweep.checkParameters({"Threads", "Repeat"}), InvalidConfigurationException);
+    REQUIRE_THROWS_AS(sweep.checkParameters({}), InvalidConfigurationException);
+}
+
+TEST_CASE("ParameterSweep reports a row per point") {
+    ParameterSweep sweep{{"Threads=1,2"}};
+    sweep.record({DefaultDriver::OutcomeCode::kSuccess, 100, 200, 1s, 100.0, 2ms, 9ms});
+    sweep.record({DefaultDriver::OutcomeCode::kSuccess, 300, 600, 1s, 300.0, 3ms, 10ms});
+    REQUIRE_THROWS(sweep.record({DefaultDriver::OutcomeCode::kSuccess, 0, 0, 1s, 0.0, 0ms, 0ms}));
+
+    std::ostringstream out;
+    sweep.report(out);
+    REQUIRE(out.str() ==
+            "ParameterSweep\n"
+            "point,Threads,outcome,iterations,operations,duration,iterations_per_second,p50,p99\n"
+            "0,1,0,100,200,1000000000,100,2000000,9000000\n"
+            "1,2,0,300,600,1000000000,300,3000000,10000000\n"
+            "\n");
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
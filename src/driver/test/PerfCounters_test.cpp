@@ -0,0 +1,141 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <driver/v1/PerfCounters.hpp>
+
+#include <metrics/MetricsReporter.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using namespace std::chrono_literals;
+using Catch::Matchers::Contains;
+
+// Whether the perf counters can be opened depends on the machine running the tests,
+// so these only check that what's reported is consistent either way.
+
+int64_t spin() {
+    volatile int64_t sum = 0;
+    for (int64_t i = 0; i < 1000 * 1000; ++i) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+// The comma-separated fields of each row of a csv section, not including its header.
+std::vector<std::vector<std::string>> section(const std::string& report, const std::string& name) {
+    std::istringstream in{report};
+    std::string line;
+    while (std::getline(in, line) && line != name) {
+    }
+    // Skip the header.
+    std::getline(in, line);
+
+    std::vector<std::vector<std::string>> rows;
+    while (std::getline(in, line) && !line.empty()) {
+        std::vector<std::string> fields;
+        std::istringstream row{line};
+        for (std::string field; std::getline(row, field, ',');) {
+            fields.push_back(field);
+        }
+        // A trailing empty field (a counter that couldn't be opened) isn't returned by getline.
+        if (line.back() == ',') {
+            fields.emplace_back();
+        }
+        rows.push_back(std::move(fields));
+    }
+    return rows;
+}
+
+TEST_CASE("ThreadPerfCounters count the calling thread") {
+    ThreadPerfCounters counters;
+    const auto before = counters.read();
+    spin();
+    std::this_thread::sleep_for(1ms);
+    const auto after = counters.read();
+
+    const auto check = [&](const char* name,
+                           const std::optional<int64_t>& first,
+                           const std::optional<int64_t>& second) {
+        INFO(name);
+        const bool opened = counters.errors().count(name) == 0;
+        REQUIRE(first.has_value() == opened);
+        REQUIRE(second.has_value() == opened);
+        if (opened) {
+            REQUIRE(*second >= *first);
+        }
+    };
+    check("cycles", before.cycles, after.cycles);
+    check("instructions", before.instructions, after.instructions);
+    check("cache_misses", before.cacheMisses, after.cacheMisses);
+    check("context_switches", before.contextSwitches, after.contextSwitches);
+
+    REQUIRE(counters.any() == (counters.errors().size() < 4));
+}
+
+TEST_CASE("PerfCounterSampler records windows per phase") {
+    metrics::Registry registry;
+    const bool available = ThreadPerfCounters{}.any();
+
+    {
+        // Long enough that only phaseStarting() and detach() record windows.
+        PerfCounterSampler sampler{registry, 1h};
+        sampler.attachCurrentThread(7u);
+        spin();
+        sampler.phaseStarting(0);
+        spin();
+        sampler.phaseStarting(1);
+        spin();
+        sampler.detach(7u);
+
+        // Detached threads aren't sampled anymore.
+        sampler.sample();
+        sampler.detach(7u);
+    }
+
+    std::ostringstream out;
+    metrics::Reporter{registry}.report(out, "cedar-csv");
+    if (!available) {
+        REQUIRE_THAT(out.str(), !Contains("PerfCounters"));
+        return;
+    }
+
+    const auto report = out.str();
+    const auto byPhase = section(report, "PerfCountersByPhase");
+    REQUIRE(byPhase.size() == 2);
+    REQUIRE(byPhase[0][0] == "7");
+    REQUIRE(byPhase[0][1] == "0");
+    REQUIRE(byPhase[1][0] == "7");
+    REQUIRE(byPhase[1][1] == "1");
+
+    // Two windows before phase 0 starts and during it, one during phase 1.
+    std::map<std::string, int> windowsByPhase;
+    for (const auto& row : section(report, "PerfCounters")) {
+        REQUIRE(row.size() == 7);
+        REQUIRE(row[1] == "7");
+        ++windowsByPhase[row[2]];
+    }
+    REQUIRE(windowsByPhase == std::map<std::string, int>{{"0", 2}, {"1", 1}});
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
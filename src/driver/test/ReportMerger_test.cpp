@@ -0,0 +1,132 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+
+#include <driver/v1/ReportMerger.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+TEST_CASE("Metrics reports are merged") {
+    SECTION("csv") {
+        std::ostringstream out;
+        mergeReports({"Clocks\n"
+                      "SystemTime,1000\n"
+                      "MetricsTime,100\n"
+                      "\n"
+                      "Counters\n"
+                      "110,Genny.ActiveActors,1\n"
+                      "130,Genny.ActiveActors,0\n"
+                      "120,Insert.id-0.op_docs,5\n"
+                      "120,Insert.id-1.op_docs,5\n"
+                      "\n"
+                      "Gauges\n"
+                      "\n"
+                      "Timers\n"
+                      "105,Genny.Setup,3\n"
+                      "120,Insert.id-1.op_timer,7\n"
+                      "\n",
+                      // Metrics clock 200 behind the first report's.
+                      "Clocks\n"
+                      "SystemTime,1000\n"
+                      "MetricsTime,300\n"
+                      "\n"
+                      "Counters\n"
+                      "315,Genny.ActiveActors,1\n"
+                      "325,Genny.ActiveActors,0\n"
+                      "320,Insert.id-0.op_docs,2\n"
+                      "\n"
+                      "Gauges\n"
+                      "\n"
+                      "Timers\n"
+                      "305,Genny.Setup,4\n"
+                      "320,Insert.id-0.op_timer,9\n"
+                      "\n"},
+                     out);
+        REQUIRE(out.str() ==
+                "Clocks\n"
+                "SystemTime,1000\n"
+                "MetricsTime,100\n"
+                "\n"
+                "Counters\n"
+                "110,Genny.ActiveActors,1\n"
+                "115,Genny.ActiveActors,2\n"
+                "125,Genny.ActiveActors,1\n"
+                "130,Genny.ActiveActors,0\n"
+                "120,Insert.id-0.op_docs,5\n"
+                "120,Insert.id-1.op_docs,5\n"
+                "120,Insert.id-2.op_docs,2\n"
+                "\n"
+                "Gauges\n"
+                "\n"
+                "Timers\n"
+                "105,Genny.Setup,3\n"
+                "120,Insert.id-1.op_timer,7\n"
+                "105,Genny.Setup,4\n"
+                "120,Insert.id-2.op_timer,9\n"
+                "\n");
+    }
+
+    SECTION("cedar-csv") {
+        std::ostringstream out;
+        mergeReports({"Clocks\n"
+                      "clock,nanoseconds\n"
+                      "SystemTime,1000\n"
+                      "MetricsTime,100\n"
+                      "\n"
+                      "OperationThreadCounts\n"
+                      "actor,operation,workers\n"
+                      "Insert,op,2\n"
+                      "\n"
+                      "Operations\n"
+                      "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n"
+                      "120,Insert,1,op,7,0,1,5,0,10\n",
+                      "Clocks\n"
+                      "clock,nanoseconds\n"
+                      "SystemTime,1000\n"
+                      "MetricsTime,100\n"
+                      "\n"
+                      "OperationThreadCounts\n"
+                      "actor,operation,workers\n"
+                      "Insert,op,1\n"
+                      "Remove,op,1\n"
+                      "\n"
+                      "Operations\n"
+                      "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n"
+                      "130,Insert,0,op,9,0,1,2,0,4\n"},
+                     out);
+        REQUIRE(out.str() ==
+                "Clocks\n"
+                "clock,nanoseconds\n"
+                "SystemTime,1000\n"
+                "MetricsTime,100\n"
+                "\n"
+                "OperationThreadCounts\n"
+                "actor,operation,workers\n"
+                "Insert,op,3\n"
+                "Remove,op,1\n"
+                "\n"
+                "Operations\n"
+                "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n"
+                "120,Insert,1,op,7,0,1,5,0,10\n"
+                "130,Insert,2,op,9,0,1,2,0,4\n"
+                "\n");
+    }
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
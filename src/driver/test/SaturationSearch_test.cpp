@@ -0,0 +1,157 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+
+#include <driver/v1/SaturationSearch.hpp>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::driver::v1 {
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+// Run the search against a fake system that meets the SLO up to `threshold`.
+SaturationSearch runSearch(int64_t min, int64_t max, int64_t trials, int64_t threshold) {
+    SaturationSearch search{min, max, trials};
+    while (auto rate = search.nextRate()) {
+        search.record({*rate, double(*rate), 1ms, *rate <= threshold});
+    }
+    return search;
+}
+
+TEST_CASE("SaturationSearch bisects towards the highest passing rate") {
+    SECTION("Converges on the threshold") {
+        auto search = runSearch(100, 10000, 20, 4321);
+        REQUIRE(search.best());
+        REQUIRE(*search.best() <= 4321);
+        REQUIRE(*search.best() >= 4321 * 99 / 100);
+
+        const auto& trajectory = search.trajectory();
+        REQUIRE(trajectory.size() <= 20);
+        REQUIRE(trajectory[0].rate == 100);
+        REQUIRE(trajectory[1].rate == 10000);
+    }
+
+    SECTION("Stops after the minimum rate fails") {
+        auto search = runSearch(100, 10000, 20, 10);
+        REQUIRE(!search.best());
+        REQUIRE(search.trajectory().size() == 1);
+    }
+
+    SECTION("Stops after the maximum rate passes") {
+        auto search = runSearch(100, 10000, 20, 1000000);
+        REQUIRE(search.best() == 10000);
+        REQUIRE(search.trajectory().size() == 2);
+    }
+
+    SECTION("Respects the trial budget") {
+        auto search = runSearch(1, 1000000, 4, 4321);
+        REQUIRE(search.trajectory().size() == 4);
+        REQUIRE(search.best());
+    }
+
+    SECTION("Reports the trajectory") {
+        auto search = runSearch(100, 200, 5, 1000);
+        std::ostringstream out;
+        search.report(out);
+        REQUIRE(out.str() ==
+                "SaturationSearch\n"
+                "trial,rate,iterations_per_second,latency,meets_slo\n"
+                "0,100,100,1000000,1\n"
+                "1,200,200,1000000,1\n"
+                "\n"
+                "SaturationResult\n"
+                "max_sustainable_rate\n"
+                "200\n");
+    }
+
+    SECTION("Rejects bad bounds") {
+        REQUIRE_THROWS_AS((SaturationSearch{0, 10, 10}), InvalidConfigurationException);
+        REQUIRE_THROWS_AS((SaturationSearch{10, 5, 10}), InvalidConfigurationException);
+        REQUIRE_THROWS_AS((SaturationSearch{1, 5, 0}), InvalidConfigurationException);
+    }
+}
+
+TEST_CASE("SaturationSearch configures each trial") {
+    const auto workload = YAML::Load(R"(
+Actors:
+- Name: Loader
+  Phases:
+  - Repeat: 1
+  - Nop: true
+- Name: Searched
+  Phases:
+  - Nop: true
+  - Duration: 10 seconds
+)");
+
+    SECTION("First trial runs every phase") {
+        const auto trial = SaturationSearch::configureTrial(workload, 1, 1000, false);
+
+        REQUIRE(!trial["Actors"][0]["Phases"][0]["Nop"]);
+        REQUIRE(!trial["Actors"][0]["Phases"][1]["GlobalRate"]);
+
+        const auto searched = trial["Actors"][1]["Phases"][1];
+        REQUIRE(searched["GlobalRate"].as<std::string>() == "1 per 1000000 nanoseconds");
+        REQUIRE(searched["RateLimiterName"].as<std::string>() == "SaturationSearch");
+    }
+
+    SECTION("Later trials only run the search phase") {
+        const auto trial = SaturationSearch::configureTrial(workload, 1, 1000, true);
+        REQUIRE(trial["Actors"][0]["Phases"][0]["Nop"].as<bool>());
+        REQUIRE(trial["Actors"][1]["Phases"][1]["GlobalRate"]);
+    }
+
+    SECTION("Other phases are replaced rather than marked Nop") {
+        const auto timed = YAML::Load(R"(
+Actors:
+- Name: Loader
+  Threads: 2
+  Phases:
+  - Duration: 1 minute
+    GlobalRate: 10 per 1 second
+  - Phase: 1..2
+    Duration: 1 minute
+)");
+        const auto trial = SaturationSearch::configureTrial(timed, 1, 1000, true);
+        const auto phases = trial["Actors"][0]["Phases"];
+        REQUIRE(phases.size() == 3);
+
+        // A Nop block that kept its Duration would still loop for it.
+        REQUIRE(phases[0].size() == 2);
+        REQUIRE(phases[0]["Phase"].as<int>() == 0);
+        REQUIRE(phases[0]["Nop"].as<bool>());
+
+        REQUIRE(phases[1]["Phase"].as<int>() == 1);
+        REQUIRE(phases[1]["Duration"]);
+        REQUIRE(phases[1]["GlobalRate"].as<std::string>() == "1 per 1000000 nanoseconds");
+
+        REQUIRE(phases[2].size() == 2);
+        REQUIRE(phases[2]["Phase"].as<int>() == 2);
+        REQUIRE(phases[2]["Nop"].as<bool>());
+    }
+
+    SECTION("Does not modify the original") {
+        SaturationSearch::configureTrial(workload, 1, 1000, true);
+        REQUIRE(!workload["Actors"][0]["Phases"][0]["Nop"]);
+        REQUIRE(!workload["Actors"][1]["Phases"][1]["GlobalRate"]);
+    }
+}
+
+}  // namespace
+}  // namespace genny::driver::v1
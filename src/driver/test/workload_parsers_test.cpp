@@ -33,6 +33,11 @@ Actors:
     GlobalRate: 1 per 2 megannum  # Removed
     SleepBefore: 2 planks         # Removed
     SleepAfter: 1 longtime        # Removed
+    Warmup: 3 minutes             # Removed
+    Cooldown: 1 minute            # Removed
+    EarlyStop:                    # Removed
+      MaxIntervalWidthPercent: 5
+      Window: 1 second
     Bar:
       Duration: "do-not-touch"
 )");
@@ -57,5 +62,74 @@ Actors:
     REQUIRE(YAML::Dump(parsedConfig) == expected);
 }
 
+TEST_CASE("WorkloadParser can be given parameter values") {
+    const auto input = (R"(
+Actors:
+- Name: WorkloadParserTest
+  Threads: {^Parameter: {Name: Threads, Default: 1}}
+  Phases:
+  - Repeat: {^Parameter: {Name: Repeat, Default: 10}}
+)");
+
+    WorkloadParser p{boost::filesystem::current_path(), {{"Threads", YAML::Load("8")}}};
+    auto parsedConfig = p.parse(input, DefaultDriver::ProgramOptions::YamlSource::kString);
+
+    REQUIRE(parsedConfig["Actors"][0]["Threads"].as<int>() == 8);
+    REQUIRE(parsedConfig["Actors"][0]["Phases"][0]["Repeat"].as<int>() == 10);
+    REQUIRE(p.parameterNames() == std::set<std::string>{"Repeat", "Threads"});
+}
+
+TEST_CASE("OnlyPhaseConverter runs just one phase") {
+    const auto workload = YAML::Load(R"(
+Actors:
+- Name: Loader
+  Phases:
+  - Repeat: 1
+  - Nop: true
+- Name: Worker
+  Phases:
+  - Phase: 0
+    Threads: 4
+    Duration: 1 minute
+  - Phase: 1..3
+    Duration: 1 minute
+  - Repeat: 10
+)");
+
+    const auto out = OnlyPhaseConverter::convert(workload, 2);
+    const auto loader = out["Actors"][0]["Phases"];
+    REQUIRE(loader.size() == 2);
+    for (const auto& block : loader) {
+        REQUIRE(block["Nop"].as<bool>());
+    }
+
+    const auto worker = out["Actors"][1]["Phases"];
+    REQUIRE(worker.size() == 5);
+
+    // Blocks for other phases are replaced, so no Duration is left to loop over.
+    REQUIRE(worker[0]["Phase"].as<int>() == 0);
+    REQUIRE(worker[0]["Nop"].as<bool>());
+    REQUIRE(worker[0]["Threads"].as<int>() == 4);
+    REQUIRE(!worker[0]["Duration"]);
+
+    // The range is split so only phase 2 runs.
+    REQUIRE(worker[1]["Phase"].as<int>() == 1);
+    REQUIRE(worker[1]["Nop"].as<bool>());
+    REQUIRE(!worker[1]["Duration"]);
+    REQUIRE(worker[2]["Phase"].as<int>() == 2);
+    REQUIRE(!worker[2]["Nop"]);
+    REQUIRE(worker[2]["Duration"].as<std::string>() == "1 minute");
+    REQUIRE(worker[3]["Phase"].as<int>() == 3);
+    REQUIRE(worker[3]["Nop"].as<bool>());
+
+    REQUIRE(worker[4]["Phase"].as<int>() == 4);
+    REQUIRE(worker[4]["Nop"].as<bool>());
+    REQUIRE(!worker[4]["Repeat"]);
+
+    // The original is untouched.
+    REQUIRE(!workload["Actors"][0]["Phases"][0]["Nop"]);
+    REQUIRE(workload["Actors"][1]["Phases"][1]["Phase"].as<std::string>() == "1..3");
+}
+
 }  // namespace
 }  // namespace genny::driver::v1
@@ -88,7 +88,7 @@ public:
     /**
      * @return the id for the Actor. Each Actor should
      * have a unique id. This is used for metrics reporting and other purposes.
-     * This is obtained from `WorkloadContext.nextActorId()` (see `Actor.cpp`)
+     * This is obtained from `ActorContext.nextActorId()` (see `Actor.cpp`)
      */
     virtual ActorId id() const {
         return _id;
@@ -60,9 +60,17 @@ public:
      */
     NodeSource(std::string yaml, std::string path);
 
+    /**
+     * @param yaml
+     *   An already-parsed yaml document.
+     * @param path
+     *   Path information. Used in error messages.
+     */
+    NodeSource(YAML::Node yaml, std::string path);
+
 private:
-    const YAML::Node _yaml;
-    const std::unique_ptr<class Node> _root;
+    const std::unique_ptr<const class NodeTree> _tree;
+    const class Node* _root;
 };
 
 /**
@@ -117,6 +125,18 @@ private:
     using ValueType = std::variant<long, std::string>;
     const ValueType _value;
 };
+
+/**
+ * Built-in types whose conversions from scalars are cached by `Node` so
+ * `maybe<T>()` and `to<T>()` only convert each scalar once.
+ */
+template <typename O>
+constexpr bool isCachedScalar = std::is_same_v<O, bool> || std::is_same_v<O, int> ||
+    std::is_same_v<O, unsigned int> || std::is_same_v<O, long> ||
+    std::is_same_v<O, unsigned long> || std::is_same_v<O, long long> ||
+    std::is_same_v<O, unsigned long long> || std::is_same_v<O, double> ||
+    std::is_same_v<O, std::string>;
+
 }  // namespace v1
 
 
@@ -538,13 +558,17 @@ public:
     friend std::ostream& operator<<(std::ostream& out, const Node& node);
 
     // Only intended to be used internally
-    explicit Node(const v1::NodeKey::Path& path, const YAML::Node yaml);
+    explicit Node(const class NodeImpl* impl);
 
 private:
     friend class NodeImpl;
 
     const YAML::Node yaml() const;
 
+    // The cached conversion of a scalar or nullptr if it isn't a scalar or can't be converted.
+    template <typename O>
+    const O* _cachedScalar() const;
+
     template <typename O, typename... Args>
     static constexpr bool isNodeConstructible() {
         // exclude is_trivially_constructible_v values because for some reason `int` and
@@ -594,10 +618,17 @@ private:
     std::optional<O> _maybeImpl(Args&&... args) const {
         static_assert(sizeof...(args) == 0,
                       "Cannot pass additional args when using built-in YAML conversion");
+        if constexpr (v1::isCachedScalar<O>) {
+            if (const O* cached = _cachedScalar<O>()) {
+                return std::make_optional<O>(*cached);
+            }
+        }
+        // Let YAML::Node throw if the conversion fails.
         return std::make_optional<O>(yaml().as<O>());
     }
 
-    const std::unique_ptr<const class NodeImpl> _impl;
+    // Owned by the NodeTree of the NodeSource.
+    const class NodeImpl* const _impl;
 };
 
 /**
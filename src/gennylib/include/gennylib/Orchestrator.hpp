@@ -16,11 +16,14 @@
 #define HEADER_8615FA7A_9344_43E1_A102_889F47CCC1A6_INCLUDED
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <functional>
 #include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
+#include <boost/fiber/condition_variable.hpp>
+
 namespace genny {
 
 class Orchestrator;
@@ -94,10 +97,40 @@ public:
 
     void addRequiredTokens(int tokens);
 
+    /**
+     * Let Actors holding `tokens` tokens sit out a phase. The phase starts without
+     * waiting for them. Used for Actor instances beyond a Phase's `Threads`.
+     */
+    void addParkedTokens(PhaseNumber phase, int tokens = 1);
+
+    /**
+     * Block until `phase` has ended without taking part in it. Only for Actors that
+     * registered with `addParkedTokens()` for `phase`.
+     *
+     * @return if there are any more phases.
+     */
+    bool parkThroughPhase(PhaseNumber phase);
+
+    /**
+     * Sleep for up to `duration` unless `phase` ends (or the workload is aborted)
+     * first, so that Actors waiting between operations don't hold up the next phase.
+     *
+     * @return whether the full duration elapsed while still in `phase`.
+     */
+    bool sleepInPhase(PhaseNumber phase, std::chrono::nanoseconds duration) const;
+
     void abort();
 
     void addPrePhaseStartHook(const OrchestratorCB& f);
 
+    /**
+     * Like `addPrePhaseStartHook()` but called without holding the Orchestrator's lock, so
+     * the hook may block for a long time (e.g. waiting on other processes) without holding
+     * up Actors that are still running or reading the current phase. These hooks run before
+     * the ones from `addPrePhaseStartHook()`, and the phase only starts once they return.
+     */
+    void addBlockingPrePhaseStartHook(const OrchestratorCB& f);
+
     /**
      * @return whether the workload should continue running. This is true as long as
      * no calls to abort() have been made.
@@ -107,10 +140,14 @@ public:
 
 private:
     mutable std::shared_mutex _mutex;
-    std::condition_variable_any _phaseChange;
+    // Fiber-aware so actors run on fibers yield their worker while waiting on a phase
+    // change. It behaves like std::condition_variable_any when used from plain threads.
+    // Mutable so sleepInPhase() can wait on it.
+    mutable boost::fibers::condition_variable_any _phaseChange;
 
     int _requireTokens = 0;
     int _currentTokens = 0;
+    std::unordered_map<PhaseNumber, int> _parkedTokens;
 
     PhaseNumber _max = 0;
     PhaseNumber _current = 0;
@@ -119,11 +156,23 @@ private:
     // continueRunning(). This gave two orders of magnitude speedup.
     std::atomic_bool _errors = false;
 
-    enum class State { PhaseEnded, PhaseStarted };
+    // PhaseStarting is while the blocking pre-phase-start hooks run without the lock.
+    enum class State { PhaseEnded, PhaseStarting, PhaseStarted };
 
     State state = State::PhaseEnded;
 
     std::vector<OrchestratorCB> _prePhaseHooks;
+    std::vector<OrchestratorCB> _blockingPrePhaseHooks;
+
+    // Tokens needed to start the current phase. Must hold the writer lock.
+    int requiredTokens() const;
+
+    // Start the current phase. Must be given the writer lock, which is released while the
+    // blocking pre-phase-start hooks run.
+    void startPhase(std::unique_lock<std::shared_mutex>& lock);
+
+    // End the current phase. Must hold the writer lock.
+    void endPhase();
 };
 
 }  // namespace genny
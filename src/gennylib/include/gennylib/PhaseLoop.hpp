@@ -15,12 +15,13 @@
 #ifndef HEADER_10276107_F885_4F2C_B99B_014AF3B4504A_INCLUDED
 #define HEADER_10276107_F885_4F2C_B99B_014AF3B4504A_INCLUDED
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <functional>
 #include <iterator>
 #include <optional>
 #include <sstream>
-#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -31,6 +32,7 @@
 #include <gennylib/InvalidConfigurationException.hpp>
 #include <gennylib/Orchestrator.hpp>
 #include <gennylib/context.hpp>
+#include <gennylib/v1/ConvergenceCheck.hpp>
 #include <gennylib/v1/GlobalRateLimiter.hpp>
 #include <gennylib/v1/Sleeper.hpp>
 
@@ -93,7 +95,10 @@ public:
                 "each thread");
         }
 
-        _sleeper.emplace(sleepBefore, sleepAfter);
+        // Most phases don't sleep. Without a Sleeper their iterations skip it altogether.
+        if (sleepBefore.count() > 0 || sleepAfter.count() > 0) {
+            _sleeper.emplace(sleepBefore, sleepAfter);
+        }
     }
 
     explicit IterationChecker(PhaseContext& phaseContext)
@@ -117,6 +122,47 @@ public:
             throw InvalidConfigurationException(msg.str());
         }
 
+        _parked = phaseContext.isParked();
+
+        _warmup = phaseContext["Warmup"].maybe<TimeSpec>().value_or(TimeSpec{});
+        _cooldown = phaseContext["Cooldown"].maybe<TimeSpec>().value_or(TimeSpec{});
+        if (_warmup.count() < 0 || _cooldown.count() < 0) {
+            std::stringstream msg;
+            msg << "Need non-negative Warmup and Cooldown. In Phase " << phaseContext.path();
+            throw InvalidConfigurationException(msg.str());
+        }
+        if (_minDuration && (_warmup || _cooldown) &&
+            _warmup.value + _cooldown.value >= _minDuration->value) {
+            std::stringstream msg;
+            msg << "Warmup and Cooldown must leave some of the Duration to be measured. In Phase "
+                << phaseContext.path();
+            throw InvalidConfigurationException(msg.str());
+        }
+        _countIterations = [&phaseContext](int64_t iterations) {
+            phaseContext.countIterations(iterations);
+        };
+        if (_warmup || _cooldown) {
+            // Each Actor instance has its own PhaseLoop and Warmup and Cooldown windows.
+            _excludeFromMetrics = [&phaseContext, id = phaseContext.actor().lastActorId()](
+                                      SteadyClock::time_point from, SteadyClock::time_point to) {
+                phaseContext.excludeFromMetrics(id, from, to);
+            };
+        }
+
+        if (const auto& earlyStop = phaseContext["EarlyStop"]) {
+            if (!_minDuration) {
+                std::stringstream msg;
+                msg << "EarlyStop needs a Duration to use as an upper bound. In Phase "
+                    << phaseContext.path();
+                throw InvalidConfigurationException(msg.str());
+            }
+            _convergence.emplace(
+                earlyStop["Percentile"].maybe<double>().value_or(99),
+                earlyStop["MaxIntervalWidthPercent"].to<double>() / 100,
+                earlyStop["Window"].to<TimeSpec>().value,
+                earlyStop["ConsecutiveWindows"].maybe<int64_t>().value_or(3));
+        }
+
         const auto rateSpec = phaseContext["GlobalRate"].maybe<RateSpec>();
         const auto rateLimiterName =
             phaseContext["RateLimiterName"].maybe<std::string>().value_or("defaultRateLimiter");
@@ -133,12 +179,16 @@ public:
                     "there's no guarantee the rate limited operation will run in the correct "
                     "phase");
             }
-            _rateLimiter =
-                phaseContext.workload().getRateLimiter(rateLimiterName, rateSpec.value());
+            // Parked instances never run the Phase so mustn't count as users of the limiter.
+            if (!_parked) {
+                _rateLimiter =
+                    phaseContext.workload().getRateLimiter(rateLimiterName, rateSpec.value());
+            }
         }
     }
 
-    constexpr void limitRate(const SteadyClock::time_point referenceStartingPoint,
+    constexpr void limitRate(const Orchestrator& orchestrator,
+                             const SteadyClock::time_point referenceStartingPoint,
                              const int64_t currentIteration,
                              const PhaseNumber inPhase) {
         // This function is called after each iteration, so we never rate limit the
@@ -156,10 +206,14 @@ public:
                     // run visibly longer than the specified duration.
                     const auto rate = _rateLimiter->getRate() > 1e9 ? 1e9 : _rateLimiter->getRate();
 
-                    // Add ±5% jitter to avoid threads waking up at once.
-                    std::this_thread::sleep_for(std::chrono::nanoseconds(
-                        int64_t(rate * (0.95 + 0.1 * (double(rand()) / RAND_MAX)))));
-                    continue;
+                    // Add ±5% jitter to avoid threads waking up at once. Stop waiting for
+                    // a token if the phase ends or the workload is aborted meanwhile.
+                    if (orchestrator.sleepInPhase(
+                            inPhase,
+                            std::chrono::nanoseconds(
+                                int64_t(rate * (0.95 + 0.1 * (double(rand()) / RAND_MAX)))))) {
+                        continue;
+                    }
                 }
                 break;
             }
@@ -171,6 +225,39 @@ public:
         return _minDuration ? SteadyClock::now() : SteadyClock::time_point::min();
     }
 
+    /**
+     * Called when an Actor starts iterating. Starts the `Warmup` window, if any.
+     */
+    void loopStarted() {
+        if (_excludeFromMetrics) {
+            _loopStartedAt = SteadyClock::now();
+        }
+    }
+
+    /**
+     * Called when an Actor is done iterating. Counts its `iterations` towards the phase
+     * and excludes what was reported during the `Warmup` and `Cooldown` windows from the
+     * metrics. The windows are part of the phase's Duration rather than in addition to it.
+     */
+    void loopFinished(int64_t iterations) {
+        if (_countIterations) {
+            _countIterations(iterations);
+        }
+        if (!_excludeFromMetrics || !_loopStartedAt) {
+            return;
+        }
+        const auto started = *_loopStartedAt;
+        const auto finished = SteadyClock::now();
+        _loopStartedAt.reset();
+
+        if (_warmup) {
+            _excludeFromMetrics(started, std::min(finished, started + _warmup.value));
+        }
+        if (_cooldown) {
+            _excludeFromMetrics(std::max(started, finished - _cooldown.value), finished);
+        }
+    }
+
     constexpr bool isDone(SteadyClock::time_point startedAt,
                           int64_t currentIteration,
                           SteadyClock::time_point now) {
@@ -178,6 +265,70 @@ public:
             (!_minDuration || (*_minDuration).value <= now - startedAt);
     }
 
+    /**
+     * Like `isDone()` but only reads the clock every few iterations.
+     *
+     * Reading the clock can cost as much as a fast operation itself, so rather than
+     * checking a Duration after every iteration we check every `_clockCheckInterval`
+     * iterations. The interval is re-tuned after each check from the average iteration
+     * time so the clock is read about once per `kClockCheckPeriod`; a phase therefore
+     * runs at most about that long past its Duration unless iterations suddenly become
+     * much slower. The interval never exceeds `kMaxClockCheckInterval` iterations.
+     *
+     * If the phase has an `EarlyStop` block the clock is read after every iteration
+     * instead, so the ConvergenceCheck gets each iteration's own time rather than an
+     * average that would hide the tail. The phase ends before its Duration once the
+     * latency estimate has converged (and any Repeat count is met).
+     */
+    bool isDone(SteadyClock::time_point startedAt, int64_t currentIteration) {
+        if (!_minDuration) {
+            // No need for the time at all.
+            return isDone(startedAt, currentIteration, SteadyClock::time_point::min());
+        }
+        const bool reachedRepeat = _minIterations && currentIteration == (*_minIterations).value;
+        if (currentIteration != 0 && currentIteration < _nextClockCheck && !reachedRepeat) {
+            // Haven't read the clock so can't know the Duration has passed. Always look
+            // once the Repeat count is reached so we don't overshoot it.
+            return false;
+        }
+
+        const auto now = SteadyClock::now();
+        if (isDone(startedAt, currentIteration, now)) {
+            return true;
+        }
+
+        if (currentIteration == 0) {
+            // Starting a new loop; forget what we learned about the last one.
+            _clockCheckInterval = 1;
+            if (_convergence) {
+                _convergence->reset(now);
+            }
+        } else {
+            const auto iterations = currentIteration - _lastClockCheckIteration;
+            const auto perIteration = (now - _lastClockCheck) / iterations;
+            if (_convergence) {
+                // The interval stays at 1, so this is a single iteration's time.
+                if (_convergence->record(now, perIteration) &&
+                    (!_minIterations || currentIteration >= (*_minIterations).value)) {
+                    return true;
+                }
+            } else {
+                const auto wanted = perIteration.count() > 0
+                    ? std::chrono::duration_cast<SteadyClock::duration>(kClockCheckPeriod) /
+                        perIteration
+                    : kMaxClockCheckInterval;
+                // Shrink immediately but only grow gradually so one burst of fast
+                // iterations can't make us stop looking at the clock.
+                _clockCheckInterval = std::clamp<int64_t>(
+                    wanted, 1, std::min(2 * _clockCheckInterval, kMaxClockCheckInterval));
+            }
+        }
+        _lastClockCheck = now;
+        _lastClockCheckIteration = currentIteration;
+        _nextClockCheck = currentIteration + _clockCheckInterval;
+        return false;
+    }
+
     constexpr bool operator==(const IterationChecker& other) const {
         return _minDuration == other._minDuration && _minIterations == other._minIterations;
     }
@@ -186,12 +337,20 @@ public:
         return _doesBlock;
     }
 
+    constexpr bool isParked() const {
+        return _parked;
+    }
+
     constexpr void sleepBefore(const Orchestrator& o, const PhaseNumber pn) const {
-        _sleeper->before(o, pn);
+        if (_sleeper) {
+            _sleeper->before(o, pn);
+        }
     }
 
     constexpr void sleepAfter(const Orchestrator& o, const PhaseNumber pn) const {
-        _sleeper->after(o, pn);
+        if (_sleeper) {
+            _sleeper->after(o, pn);
+        }
     }
 
 private:
@@ -206,6 +365,32 @@ private:
     v1::GlobalRateLimiter* _rateLimiter = nullptr;
     const bool _doesBlock;  // Computed/cached value. Computed at ctor time.
     std::optional<v1::Sleeper> _sleeper;
+
+    // This Actor instance sits the Phase out, see PhaseContext::isParked().
+    bool _parked = false;
+
+    // Metrics reported at the start and end of the loop are left out of the output.
+    TimeSpec _warmup;
+    TimeSpec _cooldown;
+    std::function<void(SteadyClock::time_point, SteadyClock::time_point)> _excludeFromMetrics;
+    std::optional<SteadyClock::time_point> _loopStartedAt;
+
+    // Counts the iterations towards WorkloadContext::iterations().
+    std::function<void(int64_t)> _countIterations;
+
+    // Set if the phase may end before its Duration.
+    std::optional<v1::ConvergenceCheck> _convergence;
+
+    // Target time between clock reads in Duration-bound phases.
+    static constexpr auto kClockCheckPeriod = std::chrono::microseconds{50};
+    static constexpr int64_t kMaxClockCheckInterval = 64;
+
+    // State for the coarse isDone(). An IterationChecker is only ever used by a single
+    // Actor so this doesn't need to be synchronized.
+    int64_t _clockCheckInterval = 1;
+    int64_t _nextClockCheck = 0;
+    int64_t _lastClockCheckIteration = 0;
+    SteadyClock::time_point _lastClockCheck;
 };
 
 
@@ -237,6 +422,9 @@ public:
           _currentIteration{0} {
         // iterationCheck should only be null if we're end() iterator.
         assert(isEndIterator == (iterationCheck == nullptr));
+        if (!isEndIterator) {
+            _iterationCheck->loopStarted();
+        }
     }
 
     // iterator concept value-type
@@ -258,21 +446,27 @@ public:
     bool operator==(const ActorPhaseIterator& rhs) const {
         if (_iterationCheck) {
             _iterationCheck->sleepBefore(*_orchestrator, _inPhase);
-            _iterationCheck->limitRate(_referenceStartingPoint, _currentIteration, _inPhase);
+            _iterationCheck->limitRate(*_orchestrator, _referenceStartingPoint, _currentIteration, _inPhase);
         }
         // clang-format off
-        return
-                // we're comparing against the .end() iterator (the common case)
-                (rhs._isEndIterator && !this->_isEndIterator &&
-                   (!_orchestrator->continueRunning() ||
-                     // ↑ orchestrator says we stop
-                     // ...or...
-                     // if we block, then check to see if we're done in current phase
-                     // else check to see if current phase has expired
-                     (_iterationCheck->doesBlockCompletion()
-                            ? _iterationCheck->isDone(_referenceStartingPoint, _currentIteration, SteadyClock::now())
-                            : _orchestrator->currentPhase() != _inPhase)))
+        // we're comparing against the .end() iterator (the common case)
+        if (rhs._isEndIterator && !this->_isEndIterator) {
+            const bool isDone =
+                    !_orchestrator->continueRunning() ||
+                    // ↑ orchestrator says we stop
+                    // ...or...
+                    // if we block, then check to see if we're done in current phase
+                    // else check to see if current phase has expired
+                    (_iterationCheck->doesBlockCompletion()
+                            ? _iterationCheck->isDone(_referenceStartingPoint, _currentIteration)
+                            : _orchestrator->currentPhase() != _inPhase);
+            if (isDone) {
+                _iterationCheck->loopFinished(_currentIteration);
+            }
+            return isDone;
+        }
 
+        return
                 // Below checks are mostly for pure correctness;
                 //   "well-formed" code will only use this iterator in range-based for-loops and will thus
                 //   never use these conditions.
@@ -280,7 +474,7 @@ public:
                 //   Could probably put these checks under a debug-build flag or something?
 
                 // this == this
-                || (this == &rhs)
+                (this == &rhs)
 
                 // neither is end iterator but have same fields
                 || (!rhs._isEndIterator && !_isEndIterator
@@ -363,10 +557,14 @@ public:
                Args&&... args)
         : _orchestrator{orchestrator},
           _currentPhase{currentPhase},
-          _value{!phaseContext.isNop() ? std::make_unique<T>(std::forward<Args>(args)...)
-                                       : nullptr},
+          _value{!phaseContext.isNop() && !phaseContext.isParked()
+                     ? std::make_unique<T>(std::forward<Args>(args)...)
+                     : nullptr},
           _iterationCheck{std::make_unique<IterationChecker>(phaseContext)} {
         static_assert(std::is_constructible_v<T, Args...>);
+        if (_iterationCheck->isParked()) {
+            _orchestrator.addParkedTokens(_currentPhase);
+        }
     }
 
     ActorPhaseIterator begin() {
@@ -387,6 +585,11 @@ public:
         return !_value;
     }
 
+    // Used by PhaseLoopIterator to skip Phases this Actor instance sits out.
+    constexpr bool isParked() const {
+        return _iterationCheck->isParked();
+    }
+
     // Could use `auto` for return-type of operator-> and operator*, but
     // IDE auto-completion likes it more if it's spelled out.
     //
@@ -473,7 +676,11 @@ public:
           _phaseMap{phaseMap},
           _isEnd{isEnd},
           _currentPhase{0},
-          _awaitingPlusPlus{false} {}
+          _awaitingPlusPlus{false} {
+        if (!_isEnd) {
+            this->skipParkedPhases(0);
+        }
+    }
 
     ActorPhase<T>& operator*() /* cannot be const */ {
         assert(!_awaitingPlusPlus);
@@ -506,6 +713,7 @@ public:
         if (this->doesBlockOn(_currentPhase)) {
             this->_orchestrator.awaitPhaseEnd(true);
         }
+        this->skipParkedPhases(_currentPhase + 1);
 
         _awaitingPlusPlus = false;
         return *this;
@@ -528,6 +736,15 @@ private:
         return true;
     }
 
+    // Wait out the Phases starting at `phase` that this Actor instance is parked in
+    // so operator*() only ever sees Phases it takes part in.
+    void skipParkedPhases(PhaseNumber phase) {
+        for (auto item = _phaseMap.find(phase); item != _phaseMap.end() && item->second.isParked();
+             item = _phaseMap.find(++phase)) {
+            this->_orchestrator.parkThroughPhase(phase);
+        }
+    }
+
     Orchestrator& _orchestrator;
     PhaseMap<T>& _phaseMap;  // cannot be const; owned by PhaseLoop
 
@@ -15,9 +15,14 @@
 #ifndef HEADER_0E802987_B910_4661_8FAB_8B952A1E453B_INCLUDED
 #define HEADER_0E802987_B910_4661_8FAB_8B952A1E453B_INCLUDED
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -134,13 +139,31 @@ public:
      * @param mongoUri the base mongo URI to use @see PoolFactory
      * @param cast source of Actors to use. Actors are constructed
      * from the cast at construction-time.
+     * @param apmCallback called whenever a command is sent to the server, see v1::PoolManager.
+     * @param setupThreads
+     *   how many threads to construct Actors on. The Actors of each `Actors:` block whose
+     *   producer is a ParallelizedActorProducer are constructed together on one thread while
+     *   other blocks are constructed on other threads. ActorIds, RNGs and rate-limiters don't
+     *   depend on the number of threads or on which block is constructed first.
      */
     WorkloadContext(const Node& node,
                     metrics::Registry& registry,
                     Orchestrator& orchestrator,
                     const std::string& mongoUri,
                     const Cast& cast,
-                    v1::PoolManager::OnCommandStartCallback apmCallback = {});
+                    v1::PoolManager::OnCommandStartCallback apmCallback = {},
+                    size_t setupThreads = 1);
+
+    /**
+     * Like the other constructor but connections come from `poolManager`. Use this to keep
+     * connection-pools open across several WorkloadContexts.
+     */
+    WorkloadContext(const Node& node,
+                    metrics::Registry& registry,
+                    Orchestrator& orchestrator,
+                    std::shared_ptr<v1::PoolManager> poolManager,
+                    const Cast& cast,
+                    size_t setupThreads = 1);
 
     // no copy or move
     WorkloadContext(WorkloadContext&) = delete;
@@ -174,8 +197,8 @@ public:
     }
 
     /**
-     * Get a WorkloadContext-unique ActorId
-     * @return The next sequential id
+     * Get a WorkloadContext-unique ActorId. Actors get theirs from ActorContext::nextActorId().
+     * @return The next sequential id not yet handed out or reserved for an ActorContext.
      */
     ActorId nextActorId() {
         return _nextActorId++;
@@ -205,14 +228,33 @@ public:
      * There is one copy of _state per (ActorT, StateT). It's up to the user to ensure
      * there're not more than one instance of StateT per ActorT to avoid them clobbering
      * each other.
+     *
+     * The states outlive the WorkloadContext, see resetActorSharedState().
      */
     template <class ActorT, class StateT = typename ActorT::StateT>
     static StateT& getActorSharedState() {
         // C++11 function statics are created in a thread-safe manner.
         static auto _state = StateT();
+        static const bool _resettable = (_addSharedStateReset([]() {
+                                             _state.~StateT();
+                                             new (&_state) StateT();
+                                         }),
+                                         true);
+        (void)_resettable;
         return _state;
     }
 
+    /**
+     * Put every state from getActorSharedState() back to a newly-constructed StateT.
+     *
+     * For running one workload several times in the same process, e.g. a parameter sweep,
+     * so Actors don't see what the previous run's Actors left behind.
+     *
+     * @warning
+     *   Only call this when no Actors exist: any references they hold become dangling.
+     */
+    static void resetActorSharedState();
+
     /**
      * ShareableState should be the base class of all shareable
      *
@@ -251,18 +293,33 @@ public:
      */
     v1::GlobalRateLimiter* getRateLimiter(const std::string& name, const RateSpec& spec);
 
+    /**
+     * @return how many PhaseLoop iterations all Actors completed in `phase`. An Actor's
+     *   iterations are counted once it's done with the phase.
+     */
+    int64_t iterations(PhaseNumber phase) const;
+
+    /**
+     * @return how many PhaseLoop iterations all Actors completed over every phase.
+     */
+    int64_t iterations() const;
+
 private:
     friend class ActorContext;
     friend class PhaseContext;
 
+    void _countIterations(PhaseNumber phase, int64_t iterations);
+
+    static void _addSharedStateReset(std::function<void()> reset);
+
     // helper methods used during construction
-    static ActorVector _constructActors(const Cast& cast,
-                                        const std::unique_ptr<ActorContext>& contexts);
+    static std::shared_ptr<ActorProducer> _findProducer(const Cast& cast,
+                                                        const ActorContext& actorContext);
 
     metrics::Registry* _registry;
     Orchestrator* _orchestrator;
 
-    v1::PoolManager _poolManager;
+    std::shared_ptr<v1::PoolManager> _poolManager;
 
     // we own the child ActorContexts
     std::vector<std::unique_ptr<ActorContext>> _actorContexts;
@@ -273,13 +330,24 @@ private:
     // should not be called after construction.
     bool _done = false;
 
-    // Actors should always be constructed in a single-threaded context.
-    // That said, atomic integral types are very cheap to work with.
+    // The next id to reserve for an ActorContext or hand out to an Actor beyond those
+    // reserved, see ActorContext::nextActorId().
     std::atomic<ActorId> _nextActorId{0};
 
+    // Actors may be constructed on several threads. These guard what they can
+    // register with the WorkloadContext while doing so.
+    std::mutex _rngLock;
+    std::mutex _rateLimitersLock;
+    mutable std::mutex _iterationsLock;
+
     std::unordered_map<ActorId, DefaultRandom> _rngRegistry;
+    // The i'th stream split from _rng is the DefaultRandom of the Actor with id i
+    // regardless of the order Actors ask for them.
+    std::vector<DefaultRandom> _rngStreams;
 
     std::unordered_map<std::string, std::unique_ptr<v1::GlobalRateLimiter>> _rateLimiters;
+
+    std::map<PhaseNumber, int64_t> _iterations;
 };
 
 // For some reason need to decl this; see impl below
@@ -395,6 +463,54 @@ public:
         return this->workload().getRNGForThread(id);
     }
 
+    /**
+     * @return how many `^Inc` values have been generated for the Actor with the given id.
+     *         Every DocumentGenerator made for that Actor counts with it, whichever Phase or
+     *         Operation it's for, so none of them repeat another's values.
+     */
+    std::atomic<uint64_t>& incCounter(ActorId id);
+
+    /**
+     * @return how many instances of this Actor to construct. This is the largest
+     *         `Threads` value given for the Actor or any of its Phases, or 1 if none is given.
+     */
+    int instanceCount() const;
+
+    /**
+     * @return the index of the instance of this Actor currently being constructed.
+     *         Set by ParallelizedActorProducer; always 0 for other producers.
+     */
+    int instance() const {
+        return _instance;
+    }
+
+    /** @private */
+    void setInstance(int instance) {
+        _instance = instance;
+    }
+
+    /**
+     * Get the id for a new Actor constructed from this context.
+     *
+     * Every ActorContext whose producer is a ParallelizedActorProducer has `instanceCount()`
+     * ids reserved for it, in configuration order, so ids match constructing every Actor one
+     * after the other no matter which thread constructs them.
+     * Beyond those, ids come from WorkloadContext::nextActorId().
+     */
+    ActorId nextActorId() {
+        _lastActorId = _nextReservedId < _reservedIdsEnd ? _nextReservedId++
+                                                          : this->workload().nextActorId();
+        return _lastActorId;
+    }
+
+    /**
+     * @return the id last handed out by nextActorId(). While an Actor is being constructed
+     *         this is its own id, the Actor base class having taken it first.
+     */
+    ActorId lastActorId() const {
+        return _lastActorId;
+    }
+
     /**
      * @return a pool from the "default" MongoDB connection-pool.
      * @throws InvalidConfigurationException if no connections available.
@@ -404,6 +520,29 @@ public:
         return this->_workload->client(std::forward<Args>(args)...);
     }
 
+    /**
+     * Get an object shared by every Actor constructed from this context, making it with
+     * `make()` for the first Actor that asks for it. The Actors run on separate threads so
+     * `T` must be safe to use from all of them, e.g. by being const.
+     *
+     * ```c++
+     * // All of an Actor's threads use the same documents.
+     * auto pool = phaseContext.actor().shared<const DocumentPool>(opNode, [&]() { ... });
+     * ```
+     *
+     * @param key the configuration the object is made from, e.g. an Operation's node.
+     * @param make returns a `std::shared_ptr<T>`.
+     */
+    template <typename T, typename F>
+    std::shared_ptr<T> shared(const Node& key, F&& make) {
+        std::lock_guard<std::mutex> lk{_sharedLock};
+        auto& out = _shared[&key];
+        if (!out) {
+            out = std::shared_ptr<T>{make()};
+        }
+        return std::const_pointer_cast<T>(std::static_pointer_cast<std::add_const_t<T>>(out));
+    }
+
     /**
      * Convenience method for creating a metrics::Operation that's unique for this actor and thread.
      *
@@ -420,8 +559,24 @@ private:
 
     constructPhaseContexts(const Node&, ActorContext*);
 
+    friend class WorkloadContext;
+
     WorkloadContext* _workload;
     std::unordered_map<PhaseNumber, std::unique_ptr<PhaseContext>> _phaseContexts;
+    int _instance = 0;
+
+    // [_nextReservedId, _reservedIdsEnd) are this context's ids still to be handed out.
+    ActorId _nextReservedId = 0;
+    ActorId _reservedIdsEnd = 0;
+    ActorId _lastActorId = 0;
+
+    // See shared().
+    std::mutex _sharedLock;
+    std::unordered_map<const Node*, std::shared_ptr<const void>> _shared;
+
+    // See incCounter().
+    std::mutex _incCountersLock;
+    std::unordered_map<ActorId, std::atomic<uint64_t>> _incCounters;
 };
 
 /**
@@ -447,6 +602,15 @@ public:
      */
     bool isNop() const;
 
+    /**
+     * A Phase's `Threads` (inherited from the Actor if not given) can be smaller than
+     * the number of Actor instances. The instances beyond it are parked for the Phase:
+     * they don't hold an Orchestrator token and sleep until the Phase is over.
+     *
+     * @return whether the Actor instance currently being constructed is parked in this Phase.
+     */
+    bool isParked() const;
+
     /**
      * @return the parent workload context
      */
@@ -480,6 +644,25 @@ public:
             this->_actor->operator[]("Name").to<std::string>(), stm.str(), id);
     }
 
+    /**
+     * Leave out everything the Actor with the given id reports between `from` and `to` from
+     * the metrics output. Used by PhaseLoop for `Warmup` and `Cooldown`.
+     */
+    void excludeFromMetrics(ActorId id,
+                            genny::metrics::time_point from,
+                            genny::metrics::time_point to) const {
+        this->workload()._registry->excludeWindow(
+            this->_actor->operator[]("Name").to<std::string>(), id, from, to);
+    }
+
+    /**
+     * Count `iterations` of this Phase towards WorkloadContext::iterations(). Used by
+     * PhaseLoop once the Actor is done with the Phase.
+     */
+    void countIterations(int64_t iterations) const {
+        this->workload()._countIterations(_phaseNumber, iterations);
+    }
+
     const auto getPhaseNumber() const {
         return _phaseNumber;
     }
@@ -18,6 +18,7 @@
 #include <chrono>
 #include <climits>
 #include <cmath>
+#include <optional>
 #include <sstream>
 
 #include <mongocxx/read_concern.hpp>
@@ -159,6 +160,36 @@ struct PhaseRangeSpec {
     genny::PhaseNumber end;
 };
 
+/**
+ * Works out which phases each block of an Actor's `Phases:` list is for. A block without a
+ * `Phase:` key is for the phase after however many phases the blocks before it were for.
+ *
+ * Anything that needs to know which block runs in which phase goes through this so it agrees
+ * with ActorContext.
+ */
+class PhaseNumbering {
+public:
+    /**
+     * @param configured the next block's `Phase:` value, if it has one.
+     * @return the phases the next block is for.
+     */
+    PhaseRangeSpec next(const std::optional<PhaseRangeSpec>& configured) {
+        const auto range = configured.value_or(PhaseRangeSpec{IntegerSpec{_count}});
+        _count += range.end - range.start + 1;
+        return range;
+    }
+
+    /**
+     * @return how many phases the blocks so far were for.
+     */
+    PhaseNumber count() const {
+        return _count;
+    }
+
+private:
+    PhaseNumber _count = 0;
+};
+
 }  // namespace genny
 
 namespace YAML {
@@ -0,0 +1,195 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_C2EB9F88_CDA6_4738_A5C0_962324194136_INCLUDED
+#define HEADER_C2EB9F88_CDA6_4738_A5C0_962324194136_INCLUDED
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include <gennylib/InvalidConfigurationException.hpp>
+#include <gennylib/conventions.hpp>
+
+#include <metrics/v1/LatencySketch.hpp>
+
+namespace genny::v1 {
+
+/**
+ * Decides when a Duration phase has run long enough for its latency
+ * estimate to be trusted so it can end early.
+ *
+ * Each window's iteration times go into their own sketch, and at the end of the
+ * window its percentile is taken as one sample (batch means). The estimate is the mean
+ * of the windows' percentiles and its 95% confidence interval comes from how much they
+ * vary, so a heavy tail that only some windows see keeps the interval wide. Once both
+ * that interval and the latest window's own distribution-free interval are within
+ * `maxRelativeWidth` of their estimates for `consecutiveWindows` windows in a row the
+ * phase has converged.
+ *
+ * Iterations have to be timed one at a time: averages over several iterations hide
+ * the tail that the percentile is meant to measure.
+ *
+ * Configured by a phase's `EarlyStop` block:
+ *
+ * ```yaml
+ * Duration: 30 minutes        # Upper bound.
+ * EarlyStop:
+ *   Percentile: 99            # Default 99.
+ *   MaxIntervalWidthPercent: 5
+ *   Window: 30 seconds
+ *   ConsecutiveWindows: 3     # Default 3.
+ * ```
+ *
+ * Not thread-safe; each Actor has its own.
+ */
+class ConvergenceCheck {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param percentile the latency percentile to estimate, in (0, 100).
+     * @param maxRelativeWidth
+     *   the widest the 95% confidence interval can be, as a fraction of the estimate.
+     * @param window how often to check the confidence interval.
+     * @param consecutiveWindows how many checks in a row have to pass.
+     */
+    ConvergenceCheck(double percentile,
+                     double maxRelativeWidth,
+                     Clock::duration window,
+                     int64_t consecutiveWindows)
+        : _quantile{percentile / 100},
+          _maxRelativeWidth{maxRelativeWidth},
+          _window{window},
+          _consecutiveWindows{consecutiveWindows} {
+        if (percentile <= 0 || percentile >= 100) {
+            std::stringstream msg;
+            msg << "EarlyStop Percentile must be between 0 and 100. Gave " << percentile;
+            throw InvalidConfigurationException(msg.str());
+        }
+        if (maxRelativeWidth <= 0) {
+            throw InvalidConfigurationException("EarlyStop MaxIntervalWidthPercent must be > 0");
+        }
+        if (window <= Clock::duration::zero()) {
+            throw InvalidConfigurationException("EarlyStop Window must be > 0");
+        }
+        if (consecutiveWindows <= 0) {
+            throw InvalidConfigurationException("EarlyStop ConsecutiveWindows must be > 0");
+        }
+    }
+
+    /**
+     * Forget everything recorded so far, e.g. because a new phase is starting.
+     */
+    void reset(Clock::time_point now) {
+        _sketch.clear();
+        _windows.clear();
+        _windowEndsAt = now + _window;
+        _passedWindows = 0;
+    }
+
+    /**
+     * Record how long one iteration took.
+     *
+     * @return whether the percentile has converged.
+     */
+    bool record(Clock::time_point now, Clock::duration latency) {
+        _sketch.add(std::chrono::duration_cast<std::chrono::nanoseconds>(latency));
+        if (now < _windowEndsAt) {
+            return hasConverged();
+        }
+        _windowEndsAt = now + _window;
+
+        // A window too short to bound its own percentile can't be one of the samples.
+        const auto windowInterval = _sketch.quantileConfidenceInterval(_quantile);
+        if (!windowInterval) {
+            _sketch.clear();
+            _passedWindows = 0;
+            return hasConverged();
+        }
+        const auto estimate = double(_sketch.quantile(_quantile).count());
+        _windows.push_back(estimate);
+        _sketch.clear();
+
+        // The window's own interval catches a tail spread out within each window, the
+        // interval over windows catches one that comes and goes between them.
+        const auto windowWidth = double((windowInterval->second - windowInterval->first).count());
+        const auto width = intervalWidth();
+        if (windowWidth <= _maxRelativeWidth * estimate && width &&
+            *width <= _maxRelativeWidth * mean()) {
+            ++_passedWindows;
+        } else {
+            _passedWindows = 0;
+        }
+        return hasConverged();
+    }
+
+    bool hasConverged() const {
+        return _passedWindows >= _consecutiveWindows;
+    }
+
+private:
+    double mean() const {
+        double sum = 0;
+        for (auto window : _windows) {
+            sum += window;
+        }
+        return sum / double(_windows.size());
+    }
+
+    // Width of the 95% confidence interval of mean(), if there are enough windows.
+    std::optional<double> intervalWidth() const {
+        const auto n = _windows.size();
+        if (n < 2) {
+            return std::nullopt;
+        }
+        const auto m = mean();
+        double squares = 0;
+        for (auto window : _windows) {
+            squares += (window - m) * (window - m);
+        }
+        const auto stddev = std::sqrt(squares / double(n - 1));
+        return 2 * studentT975(n - 1) * stddev / std::sqrt(double(n));
+    }
+
+    // The 97.5th percentile of Student's t distribution with `df` degrees of freedom.
+    static double studentT975(size_t df) {
+        static constexpr double kTable[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365,
+                                            2.306,  2.262, 2.228, 2.201, 2.179, 2.160, 2.145,
+                                            2.131,  2.120, 2.110, 2.101, 2.093, 2.086, 2.080,
+                                            2.074,  2.069, 2.064, 2.060, 2.056, 2.052, 2.048,
+                                            2.045,  2.042};
+        constexpr auto kTableSize = sizeof(kTable) / sizeof(kTable[0]);
+        return df <= kTableSize ? kTable[df - 1] : 1.96;
+    }
+
+    const double _quantile;
+    const double _maxRelativeWidth;
+    const Clock::duration _window;
+    const int64_t _consecutiveWindows;
+
+    // The current window's iterations.
+    metrics::v1::LatencySketch _sketch;
+    // The percentile of each window so far, in nanoseconds.
+    std::vector<double> _windows;
+    Clock::time_point _windowEndsAt;
+    int64_t _passedWindows = 0;
+};
+
+}  // namespace genny::v1
+
+#endif  // HEADER_C2EB9F88_CDA6_4738_A5C0_962324194136_INCLUDED
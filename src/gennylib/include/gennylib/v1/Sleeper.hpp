@@ -17,14 +17,15 @@
 
 #include <chrono>
 
+#include <gennylib/Orchestrator.hpp>
 #include <gennylib/conventions.hpp>
 
 
 namespace genny::v1 {
 
 /**
- * Class for sleeping before and after an operation. Checks that the current phase has
- * not ended before sleeping.
+ * Class for sleeping before and after an operation. Sleeps are cut short when the
+ * current phase ends.
  */
 class Sleeper {
     using Duration = genny::Duration;
@@ -50,12 +51,13 @@ public:
     Sleeper& operator=(Sleeper&& other) = delete;
 
     /**
-     * Sleep for duration before an operation. Checks that the current phase has
-     * not ended before sleeping.
+     * Sleep for duration before an operation. Doesn't sleep if the current phase has
+     * already ended and wakes up early if it ends while sleeping. A zero duration returns
+     * straight away rather than taking the Orchestrator's lock.
      */
     constexpr void before(const Orchestrator& o, const PhaseNumber pn) const {
-        if (_before.count() && o.currentPhase() == pn) {
-            std::this_thread::sleep_for(_before);
+        if (_before > Duration::zero()) {
+            o.sleepInPhase(pn, _before);
         }
     }
 
@@ -63,8 +65,8 @@ public:
      * @see Sleeper::before
      */
     constexpr void after(const Orchestrator& o, const PhaseNumber pn) const {
-        if (_after.count() && o.currentPhase() == pn) {
-            std::this_thread::sleep_for(_after);
+        if (_after > Duration::zero()) {
+            o.sleepInPhase(pn, _after);
         }
     }
 
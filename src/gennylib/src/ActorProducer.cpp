@@ -21,10 +21,12 @@ namespace genny {
 ActorVector ParallelizedActorProducer::produce(ActorContext& context) {
     ActorVector out;
 
-    auto threads = context["Threads"].maybe<int>().value_or(1);
+    auto threads = context.instanceCount();
     for (decltype(threads) i = 0; i < threads; ++i) {
+        context.setInstance(i);
         produceInto(out, context);
     }
+    context.setInstance(0);
     return out;
 }
 
@@ -1,6 +1,15 @@
-#include <utility>
-
+#include <atomic>
+#include <deque>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <gennylib/Node.hpp>
 
@@ -10,22 +19,6 @@ namespace genny {
 // Helper Functions
 //
 namespace {
-using Child = std::unique_ptr<class Node>;
-using Children = std::map<v1::NodeKey, Child>;
-using ChildKeys = std::vector<v1::NodeKey>;
-
-std::string joinPath(const v1::NodeKey::Path& path) {
-    std::stringstream out;
-    for (size_t i = 0; i < path.size(); ++i) {
-        auto key = path[i].toString();
-        out << key;
-        if (i < path.size() - 1) {
-            out << "/";
-        }
-    }
-    return out.str();
-}
-
 Node::Type determineType(const YAML::Node node) {
     auto yamlTyp = node.Type();
     switch (yamlTyp) {
@@ -55,17 +48,6 @@ YAML::Node parse(std::string yaml, const std::string& path) {
 }  // namespace
 
 
-//
-// NodeSource
-//
-
-NodeSource::NodeSource(std::string yaml, std::string path)
-    : _yaml{parse(std::move(yaml), path)},
-      _root{std::make_unique<Node>(v1::NodeKey::Path{v1::NodeKey{path}}, _yaml)} {}
-
-NodeSource::~NodeSource() = default;
-
-
 //
 // v1::NodeKey
 //
@@ -141,31 +123,62 @@ InvalidKeyException::InvalidKeyException(const std::string& msg,
 // NodeImpl
 //
 
+namespace {
+
+// Conversions of scalars to the built-in types most asked for, done on first use.
+template <typename T>
+struct CachedConversion {
+    enum State : uint8_t { kUnknown, kConverted, kFailed };
+    std::atomic<uint8_t> state{kUnknown};
+    T value{};
+};
+
+struct ScalarCache {
+    std::tuple<CachedConversion<bool>,
+               CachedConversion<int>,
+               CachedConversion<unsigned int>,
+               CachedConversion<long>,
+               CachedConversion<unsigned long>,
+               CachedConversion<long long>,
+               CachedConversion<unsigned long long>,
+               CachedConversion<double>,
+               CachedConversion<std::string>>
+        conversions;
+};
+
+// The parent of the root and the index of zombies.
+constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+}  // namespace
+
 class NodeImpl {
 public:
-    NodeImpl(const Node* self, const YAML::Node yaml, const v1::NodeKey::Path& path)
-        : _self{self},
-          _keyOrder{},
-          _children{constructChildren(path, _keyOrder, yaml)},
-          _yaml{yaml},
-          _path{path} {}
-
-    const Node& get(const v1::NodeKey& key) const {
-        auto&& it = _children.find(key);
-        if (it == _children.end()) {
-            v1::NodeKey::Path childPath = _self->_impl->_path;
-            childPath.push_back(key);
-            _children.emplace(key, std::make_unique<Node>(std::move(childPath), _zombie));
-        }
-        return *_children.at(key);
-    }
+    NodeImpl(const NodeTree* tree,
+             size_t index,
+             const NodeImpl* parent,
+             v1::NodeKey key,
+             YAML::Node yaml,
+             size_t firstChild,
+             size_t childCount)
+        : _tree{tree},
+          _index{index},
+          _parent{parent},
+          _key{std::move(key)},
+          _yaml{std::move(yaml)},
+          _type{determineType(_yaml)},
+          _firstChild{firstChild},
+          _childCount{childCount} {}
+
+    const Node& get(const std::string& key) const;
+
+    const Node& get(long index) const;
 
     const YAML::Node yaml() const {
         return _yaml;
     }
 
     Node::Type type() const {
-        return determineType(_yaml);
+        return _type;
     }
 
     std::string tag() const {
@@ -173,90 +186,272 @@ public:
     }
 
     explicit operator bool() const {
-        return bool(_yaml);
+        return _type != Node::Type::Undefined;
     }
 
     bool isScalar() const {
-        return _yaml.IsScalar();
+        return _type == Node::Type::Scalar;
     }
 
     bool isMap() const {
-        return _yaml.IsMap();
+        return _type == Node::Type::Map;
     }
 
     bool isSequence() const {
-        return _yaml.IsSequence();
+        return _type == Node::Type::Sequence;
     }
 
     bool isNull() const {
-        return _yaml.IsNull();
+        return _type == Node::Type::Null;
     }
 
     size_t size() const {
-        return _yaml.size();
+        return _childCount;
     }
 
     std::string key() const {
-        return _path.empty() ? "/" : _path.back().toString();
+        return _key.toString();
     }
 
     std::string path() const {
-        return joinPath(_path);
+        std::vector<const NodeImpl*> path;
+        for (auto impl = this; impl; impl = impl->_parent) {
+            path.push_back(impl);
+        }
+        std::stringstream out;
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            if (it != path.rbegin()) {
+                out << "/";
+            }
+            out << (*it)->_key;
+        }
+        return out.str();
     }
 
+    template <typename T>
+    const T* cached() const;
+
     friend std::ostream& operator<<(std::ostream& out, const NodeImpl& impl) {
         return out << YAML::Dump(impl._yaml);
     }
 
 private:
-    friend NodeIterator;
+    friend IteratorImpl;
+    friend class NodeTree;
+
+    const NodeTree* _tree;
+    // Position in the NodeTree or kNone for zombies.
+    const size_t _index;
+    const NodeImpl* _parent;
+    const v1::NodeKey _key;
+    const YAML::Node _yaml;
+    const Node::Type _type;
 
-    static Children constructChildren(const v1::NodeKey::Path& path,
-                                      ChildKeys& keyOrder,
-                                      const YAML::Node yaml) {
-        Children out;
-        if (!yaml.IsMap() && !yaml.IsSequence()) {
-            return out;
-        }
+    // Children are `_childCount` consecutive nodes in the NodeTree.
+    const size_t _firstChild;
+    const size_t _childCount;
 
-        int index = 0;
-        auto extractKey = [&](auto& kvp, YAML::Node iteratee) -> v1::NodeKey {
-            if (iteratee.IsMap()) {
-                return v1::NodeKey{kvp.first.template as<std::string>()};
-            } else {
-                return v1::NodeKey{index++};
+    // Only scalars that have been converted get one, see cached().
+    mutable std::atomic<ScalarCache*> _scalarCache{nullptr};
+};
+
+
+//
+// NodeTree
+//
+
+/**
+ * Every Node of a NodeSource.
+ *
+ * Nodes are built once up-front with each Node's children stored next to each
+ * other, map keys interned and indexed by a single hash-table. After that the tree
+ * is only read except for the placeholder nodes made for keys that don't exist
+ * and cached scalar conversions. Those are guarded by `_lock` so Actors can be
+ * constructed on several threads.
+ */
+class NodeTree {
+public:
+    NodeTree(YAML::Node yaml, const std::string& path) {
+        std::vector<Pending> pending;
+        pending.push_back({kNone, v1::NodeKey{path}, {}, std::move(yaml)});
+        expand(pending, 0);
+
+        for (auto& node : pending) {
+            const NodeImpl* parent = node.parent == kNone ? nullptr : &_impls[node.parent];
+            _impls.emplace_back(this,
+                                _impls.size(),
+                                parent,
+                                std::move(node.key),
+                                std::move(node.yaml),
+                                node.firstChild,
+                                node.childCount);
+            _nodes.emplace_back(&_impls.back());
+            if (parent && parent->isMap()) {
+                _mapIndex.try_emplace({node.parent, node.name}, _nodes.size() - 1);
             }
-        };
-        auto extractValue = [&](auto& kvp, YAML::Node iteratee) -> YAML::Node {
-            if (iteratee.IsMap()) {
-                return kvp.second;
+        }
+    }
+
+    const Node& root() const {
+        return _nodes.front();
+    }
+
+    const Node& node(size_t index) const {
+        return _nodes[index];
+    }
+
+    const NodeImpl& impl(size_t index) const {
+        return _impls[index];
+    }
+
+    const Node* find(const NodeImpl* map, const std::string& key) const {
+        if (auto it = _mapIndex.find({map->_index, key}); it != _mapIndex.end()) {
+            return &_nodes[it->second];
+        }
+        return nullptr;
+    }
+
+    const Node& zombie(const NodeImpl* parent, v1::NodeKey key) const {
+        std::lock_guard<std::mutex> lk{_lock};
+        auto it = _zombieIndex.find({parent, key});
+        if (it == _zombieIndex.end()) {
+            auto& impl = _zombieImpls.emplace_back(this, kNone, parent, key, _zombie, 0, 0);
+            auto& node = _zombieNodes.emplace_back(&impl);
+            it = _zombieIndex.emplace(std::make_pair(parent, std::move(key)), &node).first;
+        }
+        return *it->second;
+    }
+
+    ScalarCache& scalarCache(std::atomic<ScalarCache*>& cache) const {
+        std::lock_guard<std::mutex> lk{_lock};
+        if (!cache.load(std::memory_order_relaxed)) {
+            cache.store(&_scalarCaches.emplace_back(), std::memory_order_release);
+        }
+        return *cache.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend NodeImpl;
+
+    // A node before it's turned into a NodeImpl.
+    struct Pending {
+        size_t parent;
+        v1::NodeKey key;
+        // The interned key of map children.
+        std::string_view name;
+        YAML::Node yaml;
+        size_t firstChild = 0;
+        size_t childCount = 0;
+    };
+
+    // Add the children of pending[index] (and theirs) to `pending`.
+    void expand(std::vector<Pending>& pending, size_t index) {
+        const auto yaml = pending[index].yaml;
+        if (!yaml.IsMap() && !yaml.IsSequence()) {
+            return;
+        }
+        const auto firstChild = pending.size();
+        long seqIndex = 0;
+        for (auto&& kvp : yaml) {
+            if (yaml.IsMap()) {
+                const auto& name = *_keys.insert(kvp.first.template as<std::string>()).first;
+                pending.push_back({index, v1::NodeKey{name}, name, kvp.second});
             } else {
-                return kvp;
+                pending.push_back({index, v1::NodeKey{seqIndex++}, {}, kvp});
             }
-        };
+        }
+        pending[index].firstChild = firstChild;
+        pending[index].childCount = pending.size() - firstChild;
+        for (auto child = firstChild; child < firstChild + pending[index].childCount; ++child) {
+            expand(pending, child);
+        }
+    }
 
-        for (auto&& kvp : yaml) {
-            const auto key = extractKey(kvp, yaml);
-            keyOrder.push_back(key);
-            v1::NodeKey::Path childPath = path;
-            childPath.push_back(key);
-            out.emplace(key, std::make_unique<Node>(std::move(childPath), extractValue(kvp, yaml)));
+    struct ChildKey {
+        size_t parent;
+        std::string_view name;
+
+        bool operator==(const ChildKey& rhs) const {
+            return parent == rhs.parent && name == rhs.name;
         }
+    };
 
-        return out;
-    }
+    struct ChildKeyHash {
+        size_t operator()(const ChildKey& key) const {
+            return std::hash<std::string_view>{}(key.name) * 31 + key.parent;
+        }
+    };
 
     static const YAML::Node _zombie;
 
-    const Node* _self;
-    // these 2 need to be mutable to generate placeholder nodes for non-existent keys.
-    mutable ChildKeys _keyOrder;  // maintain insertion-order
-    mutable Children _children;
-    const YAML::Node _yaml;
-    const v1::NodeKey::Path _path;
+    // Deques so elements don't move as they're added.
+    std::deque<NodeImpl> _impls;
+    std::deque<Node> _nodes;
+    std::unordered_set<std::string> _keys;
+    std::unordered_map<ChildKey, size_t, ChildKeyHash> _mapIndex;
+
+    mutable std::mutex _lock;
+    // Placeholders for keys that don't exist. Made on first access.
+    mutable std::deque<NodeImpl> _zombieImpls;
+    mutable std::deque<Node> _zombieNodes;
+    mutable std::map<std::pair<const NodeImpl*, v1::NodeKey>, const Node*> _zombieIndex;
+    mutable std::deque<ScalarCache> _scalarCaches;
 };
 
-const YAML::Node NodeImpl::_zombie = YAML::Load("")["zombie"];
+const YAML::Node NodeTree::_zombie = YAML::Load("")["zombie"];
+
+const Node& NodeImpl::get(const std::string& key) const {
+    if (isMap()) {
+        if (auto child = _tree->find(this, key)) {
+            return *child;
+        }
+    }
+    return _tree->zombie(this, v1::NodeKey{key});
+}
+
+const Node& NodeImpl::get(long index) const {
+    if (isSequence() && index >= 0 && size_t(index) < _childCount) {
+        return _tree->node(_firstChild + index);
+    }
+    return _tree->zombie(this, v1::NodeKey{index});
+}
+
+template <typename T>
+const T* NodeImpl::cached() const {
+    if (!isScalar()) {
+        return nullptr;
+    }
+    auto* cache = _scalarCache.load(std::memory_order_acquire);
+    auto& conversion = std::get<CachedConversion<T>>(
+        (cache ? *cache : _tree->scalarCache(_scalarCache)).conversions);
+
+    auto state = conversion.state.load(std::memory_order_acquire);
+    if (state == CachedConversion<T>::kUnknown) {
+        // Another thread may be converting the same scalar.
+        std::lock_guard<std::mutex> lk{_tree->_lock};
+        state = conversion.state.load(std::memory_order_relaxed);
+        if (state == CachedConversion<T>::kUnknown) {
+            state = YAML::convert<T>::decode(_yaml, conversion.value)
+                ? CachedConversion<T>::kConverted
+                : CachedConversion<T>::kFailed;
+            conversion.state.store(state, std::memory_order_release);
+        }
+    }
+    return state == CachedConversion<T>::kConverted ? &conversion.value : nullptr;
+}
+
+
+//
+// NodeSource
+//
+
+NodeSource::NodeSource(std::string yaml, std::string path)
+    : NodeSource{parse(std::move(yaml), path), path} {}
+
+NodeSource::NodeSource(YAML::Node yaml, std::string path)
+    : _tree{std::make_unique<NodeTree>(std::move(yaml), path)}, _root{&_tree->root()} {}
+
+NodeSource::~NodeSource() = default;
 
 
 //
@@ -265,8 +460,7 @@ const YAML::Node NodeImpl::_zombie = YAML::Load("")["zombie"];
 
 Node::~Node() = default;
 
-Node::Node(const v1::NodeKey::Path& path, const YAML::Node yaml)
-    : _impl{std::make_unique<NodeImpl>(this, yaml, path)} {}
+Node::Node(const NodeImpl* impl) : _impl{impl} {}
 
 std::string Node::key() const {
     return this->_impl->key();
@@ -312,16 +506,31 @@ const YAML::Node Node::yaml() const {
     return _impl->yaml();
 }
 
+template <typename O>
+const O* Node::_cachedScalar() const {
+    return _impl->cached<O>();
+}
+
+template const bool* Node::_cachedScalar<bool>() const;
+template const int* Node::_cachedScalar<int>() const;
+template const unsigned int* Node::_cachedScalar<unsigned int>() const;
+template const long* Node::_cachedScalar<long>() const;
+template const unsigned long* Node::_cachedScalar<unsigned long>() const;
+template const long long* Node::_cachedScalar<long long>() const;
+template const unsigned long long* Node::_cachedScalar<unsigned long long>() const;
+template const double* Node::_cachedScalar<double>() const;
+template const std::string* Node::_cachedScalar<std::string>() const;
+
 Node::operator bool() const {
     return _impl->operator bool();
 }
 
 const Node& Node::operator[](long key) const {
-    return _impl->get(v1::NodeKey{key});
+    return _impl->get(key);
 }
 
 const Node& Node::operator[](const std::string& key) const {
-    return _impl->get(v1::NodeKey{key});
+    return _impl->get(key);
 }
 
 class NodeIterator Node::begin() const {
@@ -348,28 +557,28 @@ NodeIteratorValue::NodeIteratorValue(const v1::NodeKey& key, const Node& node)
 class IteratorImpl {
 public:
     void increment() {
-        ++_keyOrder;
+        ++_index;
     }
 
     bool equal(const IteratorImpl& rhs) const {
-        return _keyOrder == rhs._keyOrder;
+        return _index == rhs._index;
     }
 
     bool notEqual(const IteratorImpl& rhs) const {
-        return _keyOrder != rhs._keyOrder;
+        return _index != rhs._index;
     }
 
     const NodeIteratorValue getValue() const {
-        auto& key = *_keyOrder;
-        return {key, *_children.at(key)};
+        return {_tree->impl(_index)._key, _tree->node(_index)};
     }
 
-    explicit IteratorImpl(ChildKeys::const_iterator keyOrder, const Children& children)
-        : _keyOrder{keyOrder}, _children{children} {}
+    explicit IteratorImpl(const NodeImpl* nodeImpl, bool end)
+        : _tree{nodeImpl->_tree},
+          _index{nodeImpl->_firstChild + (end ? nodeImpl->_childCount : 0)} {}
 
 private:
-    ChildKeys::const_iterator _keyOrder;
-    const Children& _children;
+    const NodeTree* _tree;
+    size_t _index;
 };
 
 
@@ -378,8 +587,7 @@ private:
 //
 
 NodeIterator::NodeIterator(const NodeImpl* nodeImpl, bool end)
-    : _impl{std::make_unique<IteratorImpl>(
-          end ? nodeImpl->_keyOrder.end() : nodeImpl->_keyOrder.begin(), nodeImpl->_children)} {}
+    : _impl{std::make_unique<IteratorImpl>(nodeImpl, end)} {}
 NodeIterator::~NodeIterator() = default;
 
 void NodeIterator::operator++() {
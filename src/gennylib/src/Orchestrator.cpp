@@ -81,13 +81,8 @@ PhaseNumber Orchestrator::awaitPhaseStart(bool block, int addTokens) {
     _currentTokens += addTokens;
 
     const auto currentPhase = this->_current;
-    if (_currentTokens >= _requireTokens) {
-        for (auto&& cb : _prePhaseHooks) {
-            cb(this);
-        }
-        BOOST_LOG_TRIVIAL(debug) << "Beginning phase " << currentPhase;
-        _phaseChange.notify_all();
-        state = State::PhaseStarted;
+    if (_currentTokens >= requiredTokens()) {
+        startPhase(lock);
     } else {
         if (block) {
             while (state != State::PhaseStarted && !this->_errors) {
@@ -135,10 +130,7 @@ bool Orchestrator::awaitPhaseEnd(bool block, int removeTokens) {
     // compare with >= rather than ==.
 
     if (_currentTokens <= 0) {
-        ++_current;
-        BOOST_LOG_TRIVIAL(debug) << "Ended phase " << (this->_current - 1);
-        _phaseChange.notify_all();
-        state = State::PhaseEnded;
+        endPhase();
     } else {
         if (block) {
             while (state != State::PhaseEnded && !this->_errors) {
@@ -150,10 +142,79 @@ bool Orchestrator::awaitPhaseEnd(bool block, int removeTokens) {
 }
 
 
+void Orchestrator::addParkedTokens(PhaseNumber phase, int tokens) {
+    writer lock{_mutex};
+
+    this->_parkedTokens[phase] += tokens;
+}
+
+bool Orchestrator::parkThroughPhase(PhaseNumber phase) {
+    writer lock{_mutex};
+
+    while (this->_current <= phase && !this->_errors) {
+        if (this->_current == phase && state == State::PhaseEnded && requiredTokens() <= 0) {
+            // Every Actor sits this phase out so nobody else will start or end it.
+            startPhase(lock);
+            endPhase();
+            break;
+        }
+        _phaseChange.wait(lock);
+    }
+    return morePhaseLogic(this->_current, this->_max, this->_errors);
+}
+
+int Orchestrator::requiredTokens() const {
+    if (auto parked = _parkedTokens.find(_current); parked != _parkedTokens.end()) {
+        return _requireTokens - parked->second;
+    }
+    return _requireTokens;
+}
+
+void Orchestrator::startPhase(writer& lock) {
+    if (!_blockingPrePhaseHooks.empty()) {
+        // Every token is in, so nobody else will try to start the phase in the meantime
+        // and the Actors waiting for it keep waiting until it's PhaseStarted.
+        state = State::PhaseStarting;
+        lock.unlock();
+        for (auto&& cb : _blockingPrePhaseHooks) {
+            cb(this);
+        }
+        lock.lock();
+    }
+    for (auto&& cb : _prePhaseHooks) {
+        cb(this);
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Beginning phase " << _current;
+    _phaseChange.notify_all();
+    state = State::PhaseStarted;
+}
+
+void Orchestrator::endPhase() {
+    ++_current;
+    BOOST_LOG_TRIVIAL(debug) << "Ended phase " << (this->_current - 1);
+    _phaseChange.notify_all();
+    state = State::PhaseEnded;
+}
+
+bool Orchestrator::sleepInPhase(PhaseNumber phase, std::chrono::nanoseconds duration) const {
+    reader lock{_mutex};
+
+    // endPhase() and abort() notify while holding the writer lock so we can't miss them.
+    return !_phaseChange.wait_for(lock, duration, [&]() {
+        return this->_current != phase || this->_errors;
+    });
+}
+
 void Orchestrator::addPrePhaseStartHook(const OrchestratorCB& f) {
+    writer lock{_mutex};
     _prePhaseHooks.push_back(f);
 }
 
+void Orchestrator::addBlockingPrePhaseStartHook(const OrchestratorCB& f) {
+    writer lock{_mutex};
+    _blockingPrePhaseHooks.push_back(f);
+}
+
 void Orchestrator::abort() {
     writer lock{_mutex};
     this->_errors = true;
@@ -14,9 +14,16 @@
 
 #include <gennylib/context.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <mongocxx/instance.hpp>
 #include <mongocxx/pool.hpp>
@@ -25,18 +32,54 @@
 #include <gennylib/Cast.hpp>
 
 namespace genny {
+namespace {
+
+RandomEngine parseRandomEngine(const Node& node) {
+    const auto name = node.maybe<std::string>().value_or("mt19937_64");
+    if (name == "mt19937_64") {
+        return RandomEngine::kMt19937_64;
+    }
+    if (name == "xoshiro256pp") {
+        return RandomEngine::kXoshiro256pp;
+    }
+    if (name == "pcg64") {
+        return RandomEngine::kPcg64;
+    }
+    throw InvalidConfigurationException("Unknown RandomEngine '" + name +
+                                        "', expected mt19937_64, xoshiro256pp or pcg64");
+}
+
+// Resets for every getActorSharedState() created so far.
+std::mutex sharedStateResetsLock;
+std::vector<std::function<void()>> sharedStateResets;
+
+}  // namespace
 
 WorkloadContext::WorkloadContext(const Node& node,
                                  metrics::Registry& registry,
                                  Orchestrator& orchestrator,
                                  const std::string& mongoUri,
                                  const Cast& cast,
-                                 v1::PoolManager::OnCommandStartCallback apmCallback)
+                                 v1::PoolManager::OnCommandStartCallback apmCallback,
+                                 size_t setupThreads)
+    : WorkloadContext{node,
+                      registry,
+                      orchestrator,
+                      std::make_shared<v1::PoolManager>(mongoUri, std::move(apmCallback)),
+                      cast,
+                      setupThreads} {}
+
+WorkloadContext::WorkloadContext(const Node& node,
+                                 metrics::Registry& registry,
+                                 Orchestrator& orchestrator,
+                                 std::shared_ptr<v1::PoolManager> poolManager,
+                                 const Cast& cast,
+                                 size_t setupThreads)
     : v1::HasNode{node},
       _registry{&registry},
       _orchestrator{&orchestrator},
       _rateLimiters{10},
-      _poolManager{mongoUri, apmCallback} {
+      _poolManager{std::move(poolManager)} {
 
     std::set<std::string> validSchemaVersions{"2018-07-01"};
 
@@ -59,10 +102,67 @@ WorkloadContext::WorkloadContext(const Node& node,
 
     // Default value selected from random.org, by selecting 2 random numbers
     // between 1 and 10^9 and concatenating.
-    _rng.seed((*this)["RandomSeed"].maybe<long>().value_or(269849313357703264));
+    // Each Actor's RNG is split from this one, see getRNGForThread().
+    _rng = DefaultRandom{v1::SelectableEngine{
+        parseRandomEngine((*this)["RandomEngine"]),
+        static_cast<DefaultRandom::result_type>(
+            (*this)["RandomSeed"].maybe<long>().value_or(269849313357703264))}};
+
+    // Producers other than ParallelizedActorProducer may make any number of Actors so only
+    // ParallelizedActorProducers can have ActorIds reserved up-front and be constructed in
+    // parallel. The others are constructed as soon as they're reached so every Actor gets the
+    // id it would get if all of them were constructed one after the other.
+    std::vector<std::shared_ptr<ActorProducer>> producers;
+    std::vector<ActorVector> produced(_actorContexts.size());
+    auto produce = [&](size_t i) { produced[i] = producers[i]->produce(*_actorContexts[i]); };
+
+    std::vector<size_t> parallel;
+    for (size_t i = 0; i < _actorContexts.size(); ++i) {
+        auto& actorContext = *_actorContexts[i];
+        producers.push_back(_findProducer(cast, actorContext));
+        if (dynamic_cast<ParallelizedActorProducer*>(producers.back().get())) {
+            actorContext._nextReservedId = _nextActorId;
+            _nextActorId += actorContext.instanceCount();
+            actorContext._reservedIdsEnd = _nextActorId;
+            parallel.push_back(i);
+        } else {
+            produce(i);
+        }
+    }
 
-    for (auto& actorContext : _actorContexts) {
-        for (auto&& actor : _constructActors(cast, actorContext)) {
+    const auto threads = std::min(std::max<size_t>(setupThreads, 1), parallel.size());
+    if (threads <= 1) {
+        std::for_each(parallel.begin(), parallel.end(), produce);
+    } else {
+        std::atomic<size_t> next = 0;
+        std::mutex failureLock;
+        std::exception_ptr failure;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for (size_t i; (i = next++) < parallel.size();) {
+                    try {
+                        produce(parallel[i]);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lk{failureLock};
+                        if (!failure) {
+                            failure = std::current_exception();
+                        }
+                        // Don't bother constructing the rest.
+                        next = parallel.size();
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+    for (auto& actors : produced) {
+        for (auto&& actor : actors) {
             _actors.push_back(std::move(actor));
         }
     }
@@ -70,29 +170,33 @@ WorkloadContext::WorkloadContext(const Node& node,
     _done = true;
 }
 
-ActorVector WorkloadContext::_constructActors(const Cast& cast,
-                                              const std::unique_ptr<ActorContext>& actorContext) {
-    auto actors = ActorVector{};
-    auto name = (*actorContext)["Type"].to<std::string>();
+void WorkloadContext::_addSharedStateReset(std::function<void()> reset) {
+    std::lock_guard<std::mutex> lk{sharedStateResetsLock};
+    sharedStateResets.push_back(std::move(reset));
+}
+
+void WorkloadContext::resetActorSharedState() {
+    std::lock_guard<std::mutex> lk{sharedStateResetsLock};
+    for (const auto& reset : sharedStateResets) {
+        reset();
+    }
+}
 
-    std::shared_ptr<ActorProducer> producer;
+std::shared_ptr<ActorProducer> WorkloadContext::_findProducer(const Cast& cast,
+                                                              const ActorContext& actorContext) {
+    auto name = actorContext["Type"].to<std::string>();
     try {
-        producer = cast.getProducer(name);
+        return cast.getProducer(name);
     } catch (const std::out_of_range&) {
         std::ostringstream stream;
         stream << "Unable to construct actors: No producer for '" << name << "'." << std::endl;
         cast.streamProducersTo(stream);
         throw InvalidConfigurationException(stream.str());
     }
-
-    for (auto&& actor : producer->produce(*actorContext)) {
-        actors.emplace_back(std::forward<std::unique_ptr<Actor>>(actor));
-    }
-    return actors;
 }
 
 mongocxx::pool::entry WorkloadContext::client(const std::string& name, size_t instance) {
-    return _poolManager.client(name, instance, this->_node);
+    return _poolManager->client(name, instance, this->_node);
 }
 
 v1::GlobalRateLimiter* WorkloadContext::getRateLimiter(const std::string& name,
@@ -100,6 +204,7 @@ v1::GlobalRateLimiter* WorkloadContext::getRateLimiter(const std::string& name,
     if (this->isDone()) {
         BOOST_THROW_EXCEPTION(std::logic_error("Cannot create rate-limiters after setup"));
     }
+    std::lock_guard<std::mutex> lk{_rateLimitersLock};
     if (_rateLimiters.count(name) == 0) {
         _rateLimiters.emplace(std::make_pair(name, std::make_unique<v1::GlobalRateLimiter>(spec)));
     }
@@ -112,12 +217,36 @@ v1::GlobalRateLimiter* WorkloadContext::getRateLimiter(const std::string& name,
     return rl;
 }
 
+int64_t WorkloadContext::iterations(PhaseNumber phase) const {
+    std::lock_guard<std::mutex> lk{_iterationsLock};
+    const auto it = _iterations.find(phase);
+    return it == _iterations.end() ? 0 : it->second;
+}
+
+int64_t WorkloadContext::iterations() const {
+    std::lock_guard<std::mutex> lk{_iterationsLock};
+    int64_t total = 0;
+    for (const auto& [phase, iterations] : _iterations) {
+        total += iterations;
+    }
+    return total;
+}
+
+void WorkloadContext::_countIterations(PhaseNumber phase, int64_t iterations) {
+    std::lock_guard<std::mutex> lk{_iterationsLock};
+    _iterations[phase] += iterations;
+}
+
 DefaultRandom& WorkloadContext::getRNGForThread(ActorId id) {
     if (this->isDone()) {
         BOOST_THROW_EXCEPTION(std::logic_error("Cannot create RNGs after setup"));
     }
+    std::lock_guard<std::mutex> lk{_rngLock};
     if (auto rng = _rngRegistry.find(id); rng == _rngRegistry.end()) {
-        auto [it, success] = _rngRegistry.try_emplace(id, _rng());
+        while (_rngStreams.size() <= id) {
+            _rngStreams.push_back(_rng.split());
+        }
+        auto [it, success] = _rngRegistry.try_emplace(id, std::move(_rngStreams[id]));
         if (!success) {
             // This should be impossible.
             // But invariants don't hurt we only call this during setup
@@ -135,7 +264,7 @@ std::unordered_map<PhaseNumber, std::unique_ptr<PhaseContext>> ActorContext::con
     if (!phases) {
         return out;
     }
-    PhaseNumber lastPhaseNumber = 0;
+    PhaseNumbering numbering;
     for (const auto& [k, phase] : phases) {
         // If we don't have a node or we are a null type, then we are a Nop
         if (!phase || phase.isNull()) {
@@ -144,8 +273,8 @@ std::unordered_map<PhaseNumber, std::unique_ptr<PhaseContext>> ActorContext::con
                   "Every phase should have at least be an empty map.";
             throw InvalidConfigurationException(ss.str());
         }
-        PhaseRangeSpec configuredRange = phase["Phase"].maybe<PhaseRangeSpec>().value_or(
-            PhaseRangeSpec{IntegerSpec{lastPhaseNumber}});
+        PhaseNumber lastPhaseNumber = numbering.count();
+        const auto configuredRange = numbering.next(phase["Phase"].maybe<PhaseRangeSpec>());
         for (PhaseNumber rangeIndex = configuredRange.start; rangeIndex <= configuredRange.end;
              rangeIndex++) {
             auto [it, success] = out.try_emplace(
@@ -162,8 +291,33 @@ std::unordered_map<PhaseNumber, std::unique_ptr<PhaseContext>> ActorContext::con
     return out;
 }
 
+std::atomic<uint64_t>& ActorContext::incCounter(ActorId id) {
+    std::lock_guard<std::mutex> lk{_incCountersLock};
+    return _incCounters.try_emplace(id, 0).first->second;
+}
+
 bool PhaseContext::isNop() const {
     auto& nop = (*this)["Nop"];
     return nop.maybe<bool>().value_or(false);
 }
+
+bool PhaseContext::isParked() const {
+    auto threads = (*this)["Threads"].maybe<int>().value_or(
+        (*_actor)["Threads"].maybe<int>().value_or(1));
+    return _actor->instance() >= threads;
+}
+
+int ActorContext::instanceCount() const {
+    auto count = (*this)["Threads"].maybe<int>().value_or(1);
+    for (auto&& [num, phase] : _phaseContexts) {
+        auto threads = (*phase)["Threads"].maybe<int>().value_or(count);
+        if (threads < 0) {
+            std::stringstream msg;
+            msg << "Need non-negative Threads. Gave " << threads << " in Phase " << num;
+            throw InvalidConfigurationException(msg.str());
+        }
+        count = std::max(count, threads);
+    }
+    return count;
+}
 }  // namespace genny
@@ -0,0 +1,107 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <gennylib/v1/ConvergenceCheck.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny::v1 {
+namespace {
+
+using namespace std::literals::chrono_literals;
+using Clock = ConvergenceCheck::Clock;
+
+TEST_CASE("ConvergenceCheck") {
+    auto now = Clock::time_point{};
+    ConvergenceCheck check{99, 0.05, 1s, 3};
+    check.reset(now);
+
+    SECTION("Converges after enough stable windows") {
+        int windows = 0;
+        while (!check.hasConverged()) {
+            REQUIRE(windows < 10);
+            // Latencies spread evenly between 1 and 2 milliseconds.
+            for (int i = 0; i < 1000; ++i) {
+                check.record(now, 1ms + i * 1us);
+            }
+            now += 1s;
+            check.record(now, 1ms);
+            ++windows;
+        }
+        // Every window has plenty of data-points but it takes two of them to have an
+        // interval at all, then we wait for the consecutive windows.
+        REQUIRE(windows == 4);
+    }
+
+    SECTION("Doesn't converge without enough data-points") {
+        for (int window = 0; window < 10; ++window) {
+            now += 1s;
+            REQUIRE(!check.record(now, 1ms, 1));
+        }
+    }
+
+    SECTION("Doesn't converge if the tail is spread out") {
+        for (int window = 0; window < 10; ++window) {
+            for (int i = 0; i < 1000; ++i) {
+                // 1% of iterations are anywhere from 1ms to 1s.
+                check.record(now, i % 100 == 0 ? 1ms * (window * 100 + i) : 1ms);
+            }
+            now += 1s;
+            REQUIRE(!check.record(now, 1ms, 1));
+        }
+    }
+
+    SECTION("Doesn't converge early on a heavy-tailed latency source") {
+        // Pareto-distributed latencies with a tail index of 1.1 like many real services
+        // under load: the mean barely exists and any window's p99 could be far off.
+        std::mt19937_64 rng{1234};
+        std::uniform_real_distribution<double> uniform{0, 1};
+        for (int window = 0; window < 50; ++window) {
+            for (int i = 0; i < 10000; ++i) {
+                const auto latency = 1ms * std::pow(1 - uniform(rng), -1 / 1.1);
+                check.record(now, std::chrono::duration_cast<Clock::duration>(latency));
+            }
+            now += 1s;
+            REQUIRE(!check.record(now, 1ms));
+        }
+    }
+
+    SECTION("Reset forgets progress") {
+        for (int window = 0; window < 2; ++window) {
+            for (int i = 0; i < 10000; ++i) {
+                check.record(now, 1ms);
+            }
+            now += 1s;
+            check.record(now, 1ms);
+        }
+        check.reset(now);
+        REQUIRE(!check.hasConverged());
+        now += 1s;
+        REQUIRE(!check.record(now, 1ms, 1));
+    }
+
+    SECTION("Validates configuration") {
+        REQUIRE_THROWS_AS((ConvergenceCheck{100, 0.05, 1s, 3}), InvalidConfigurationException);
+        REQUIRE_THROWS_AS((ConvergenceCheck{99, 0, 1s, 3}), InvalidConfigurationException);
+        REQUIRE_THROWS_AS((ConvergenceCheck{99, 0.05, 0s, 3}), InvalidConfigurationException);
+        REQUIRE_THROWS_AS((ConvergenceCheck{99, 0.05, 1s, 0}), InvalidConfigurationException);
+    }
+}
+
+}  // namespace
+}  // namespace genny::v1
@@ -3,6 +3,7 @@
 #include <catch2/catch.hpp>
 
 #include <map>
+#include <thread>
 #include <vector>
 
 namespace genny {
@@ -1161,4 +1162,64 @@ SingleItemList: [37]
     }
 }
 
+TEST_CASE("Converted scalars are cached") {
+    NodeSource ns{R"(
+Number: 7
+Word: seven
+Big: 12345678901
+)",
+                  ""};
+    const auto& node = ns.root();
+
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(node["Number"].to<int>() == 7);
+        REQUIRE(node["Number"].to<long>() == 7);
+        REQUIRE(node["Number"].to<double>() == 7.0);
+        REQUIRE(node["Number"].to<std::string>() == "7");
+        REQUIRE(node["Word"].to<std::string>() == "seven");
+        REQUIRE(node["Big"].to<long>() == 12345678901L);
+
+        // Failed conversions keep failing the same way.
+        REQUIRE_THROWS_AS(node["Word"].to<int>(), InvalidConversionException);
+        REQUIRE_THROWS_AS(node["Big"].to<int>(), InvalidConversionException);
+        REQUIRE_THROWS_AS(node["Number"].to<bool>(), InvalidConversionException);
+    }
+}
+
+TEST_CASE("Nodes can be looked up from several threads") {
+    NodeSource ns{R"(
+Actors:
+- Name: One
+  Threads: 1
+- Name: Two
+  Threads: 2
+)",
+                  ""};
+    const auto& node = ns.root();
+
+    std::vector<const Node*> missing(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < missing.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                const auto& actor = node["Actors"][i % 2];
+                if (actor["Threads"].to<int>() != i % 2 + 1) {
+                    return;
+                }
+                missing[t] = &actor["Missing"]["Deeper"];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto* zombie : missing) {
+        // Everyone gets the same placeholder for the same missing key.
+        REQUIRE(zombie == &node["Actors"][1]["Missing"]["Deeper"]);
+        REQUIRE(!*zombie);
+        REQUIRE(zombie->path() == "/Actors/1/Missing/Deeper");
+    }
+}
+
 }  // namespace genny
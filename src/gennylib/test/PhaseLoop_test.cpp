@@ -14,6 +14,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <mutex>
 #include <optional>
 
 #include "NopActor.hpp"
@@ -117,6 +118,46 @@ TEST_CASE("Correctness for N milliseconds") {
         REQUIRE(elapsed >= 10);
         REQUIRE(elapsed <= 11);
     }
+    SECTION("Looping for 10 milliseconds with slow iterations still ends on time") {
+        // The clock is only read every few iterations for fast loops; make sure that
+        // doesn't let slower loops overrun.
+        v1::ActorPhase<int> loop{
+            o,
+            std::make_unique<v1::IterationChecker>(10_ots, nullopt, false, 0_ts, 0_ts, nullopt),
+            0};
+
+        auto start = chrono::system_clock::now();
+        for (auto _ : loop) {
+            // Busy-wait rather than sleep so the iteration time is predictable.
+            auto iterationStart = chrono::steady_clock::now();
+            while (chrono::steady_clock::now() - iterationStart < chrono::microseconds{100}) {
+            }
+        }
+        auto elapsed =
+            chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - start)
+                .count();
+
+        REQUIRE(elapsed >= 10);
+        REQUIRE(elapsed <= 11);
+    }
+    SECTION("Loops can be run again") {
+        v1::ActorPhase<int> loop{
+            o,
+            std::make_unique<v1::IterationChecker>(5_ots, nullopt, false, 0_ts, 0_ts, nullopt),
+            0};
+
+        for (int run = 0; run < 2; ++run) {
+            auto start = chrono::system_clock::now();
+            for (auto _ : loop) {
+            }  // nop
+            auto elapsed =
+                chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - start)
+                    .count();
+
+            REQUIRE(elapsed >= 5);
+            REQUIRE(elapsed <= 6);
+        }
+    }
 }
 
 TEST_CASE("Combinations of duration and iterations") {
@@ -407,6 +448,60 @@ TEST_CASE("Actual Actor Example") {
         REQUIRE(duration < 550ms);
     }
 
+    SECTION("EarlyStop ends a Duration phase once latencies converge") {
+        using namespace std::literals::chrono_literals;
+        NodeSource config(R"(
+            SchemaVersion: 2018-07-01
+            Actors:
+            - Type: Inc
+              Name: Inc
+              Phases:
+              - Duration: 10 seconds
+                EarlyStop:
+                  MaxIntervalWidthPercent: 50
+                  Window: 10 milliseconds
+                  ConsecutiveWindows: 2
+                Key: 71
+        )",
+                          "");
+
+        auto imvProducer = std::make_shared<CounterProducer<IncrementsMapValues>>("Inc");
+        ActorHelper ah(config.root(), 1, {{"Inc", imvProducer}});
+
+        auto start = std::chrono::high_resolution_clock::now();
+        ah.run();
+
+        auto duration = std::chrono::high_resolution_clock::now() - start;
+
+        REQUIRE(duration >= 20ms);
+        REQUIRE(duration < 5s);
+        REQUIRE(imvProducer->counters[72] > 0);
+    }
+
+    SECTION("EarlyStop requires Duration") {
+        NodeSource config(R"(
+            SchemaVersion: 2018-07-01
+            Actors:
+            - Type: Inc
+              Name: Inc
+              Phases:
+              - Repeat: 3
+                EarlyStop:
+                  MaxIntervalWidthPercent: 5
+                  Window: 10 milliseconds
+                Key: 71
+        )",
+                          "");
+
+        auto imvProducer = std::make_shared<CounterProducer<IncrementsMapValues>>("Inc");
+
+        REQUIRE_THROWS_WITH(([&]() {
+                                ActorHelper ah(config.root(), 1, {{"Inc", imvProducer}});
+                                ah.run();
+                            }()),
+                            Catch::Contains("EarlyStop needs a Duration"));
+    }
+
     SECTION("SleepBefore < 0") {
         using namespace std::literals::chrono_literals;
         NodeSource config(R"(
@@ -505,3 +600,74 @@ TEST_CASE("Actual Actor Example") {
                             Catch::Matches(".*Must specify 'Blocking: None'.*"));
     }
 }
+
+TEST_CASE("Phases can use fewer Threads than the Actor has") {
+    struct Counts {
+        std::mutex lock;
+        std::unordered_map<PhaseNumber, int> iterations;
+    };
+
+    class CountsPerPhase : public Actor {
+        struct Config {
+            Config(PhaseContext&) {}
+        };
+
+        PhaseLoop<Config> _loop;
+        Counts& _counts;
+
+    public:
+        CountsPerPhase(ActorContext& context, Counts& counts)
+            : Actor(context), _loop{context}, _counts{counts} {}
+
+        void run() override {
+            for (auto&& cfg : _loop) {
+                for (auto&& _ : cfg) {
+                    std::lock_guard<std::mutex> lk{_counts.lock};
+                    ++_counts.iterations[cfg.phaseNumber()];
+                }
+            }
+        }
+    };
+
+    struct CountsProducer : public ParallelizedActorProducer {
+        using ParallelizedActorProducer::ParallelizedActorProducer;
+
+        void produceInto(ActorVector& out, ActorContext& context) override {
+            out.emplace_back(std::make_unique<CountsPerPhase>(context, counts));
+        }
+
+        Counts counts;
+    };
+
+    NodeSource config(R"(
+        SchemaVersion: 2018-07-01
+        Actors:
+        - Type: Count
+          Name: Count
+          Threads: 2
+          Phases:
+          - Repeat: 10
+          - Repeat: 10
+            Threads: 5
+          - Repeat: 10
+            Threads: 0
+          - Repeat: 10
+    )",
+                      "");
+
+    auto producer = std::make_shared<CountsProducer>("Count");
+    // The Actor is constructed as many times as the largest Threads, each taking a token.
+    ActorHelper ah(config.root(), 5, {{"Count", producer}});
+    ah.run();
+
+    // Instances beyond a Phase's Threads don't run it, and a Phase with no
+    // Threads at all is skipped rather than waiting forever.
+    REQUIRE(producer->counts.iterations ==
+            std::unordered_map<PhaseNumber, int>{{0, 20}, {1, 50}, {3, 20}});
+
+    // The WorkloadContext counts the same iterations.
+    REQUIRE(ah.workload()->iterations(0) == 20);
+    REQUIRE(ah.workload()->iterations(1) == 50);
+    REQUIRE(ah.workload()->iterations(2) == 0);
+    REQUIRE(ah.workload()->iterations() == 90);
+}
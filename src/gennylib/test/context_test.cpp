@@ -16,9 +16,13 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <optional>
+#include <sstream>
 #include <string_view>
 #include <thread>
+#include <tuple>
 
 #include <yaml-cpp/yaml.h>
 
@@ -563,6 +567,10 @@ TEST_CASE("Actors Share WorkloadContext State") {
 
     REQUIRE(WorkloadContext::getActorSharedState<DummyInsert, DummyInsert::InsertCounter>() ==
             10 * 10);
+
+    // E.g. between the points of a parameter sweep.
+    WorkloadContext::resetActorSharedState();
+    REQUIRE(WorkloadContext::getActorSharedState<DummyInsert, DummyInsert::InsertCounter>() == 0);
 }
 
 struct TakesInt {
@@ -685,3 +693,221 @@ TEST_CASE("If no producer exists for an actor, then we should throw an error") {
             test(), Matches(R"(Unable to construct actors: No producer for 'Bar'(.*\n*)*)"));
     }
 }
+
+namespace {
+// id -> (actor name, instance, first random number)
+using Constructed = std::map<ActorId, std::tuple<std::string, int, DefaultRandom::result_type>>;
+
+std::mutex constructedLock;
+Constructed constructed;
+
+struct RecordingActor : public Actor {
+    explicit RecordingActor(ActorContext& context) : Actor(context) {
+        const auto name = context["Name"].to<std::string>();
+        const auto value = context.workload().getRNGForThread(this->id())();
+        context.workload().getRateLimiter(name, RateSpec{1000, 1});
+        std::lock_guard<std::mutex> lk{constructedLock};
+        constructed[this->id()] = {name, context.instance(), value};
+    }
+
+    void run() override {}
+
+    static std::string_view defaultName() {
+        return "Recording";
+    }
+};
+
+// Not a ParallelizedActorProducer so it gets no ids reserved and isn't run on a setup thread.
+struct SerialRecordingProducer : public ActorProducer {
+    SerialRecordingProducer() : ActorProducer("SerialRecording") {}
+
+    ActorVector produce(ActorContext& context) override {
+        ActorVector out;
+        for (int i = 0; i < context.instanceCount(); ++i) {
+            context.setInstance(i);
+            out.push_back(std::make_unique<RecordingActor>(context));
+        }
+        context.setInstance(0);
+        return out;
+    }
+};
+}  // namespace
+
+TEST_CASE("Actors constructed on several threads get the same ids and RNGs") {
+    NodeSource ns(R"(
+    SchemaVersion: 2018-07-01
+    RandomSeed: 1234
+    Actors:
+    - Name: Three
+      Type: Recording
+      Threads: 3
+    - Name: One
+      Type: Recording
+    - Name: Four
+      Type: Recording
+      Threads: 4
+    )",
+                  "");
+
+    auto construct = [&](size_t setupThreads) {
+        constructed.clear();
+        genny::metrics::Registry metrics;
+        genny::Orchestrator orchestrator{};
+        auto cast = Cast{{"Recording", std::make_shared<DefaultActorProducer<RecordingActor>>()}};
+        auto context = WorkloadContext{
+            ns.root(), metrics, orchestrator, mongoUri.data(), cast, {}, setupThreads};
+        REQUIRE(std::distance(context.actors().begin(), context.actors().end()) == 8);
+        return constructed;
+    };
+
+    const auto serial = construct(1);
+    REQUIRE(serial.size() == 8);
+    REQUIRE(std::get<0>(serial.at(0)) == "Three");
+    REQUIRE(std::get<0>(serial.at(3)) == "One");
+    REQUIRE(std::get<0>(serial.at(4)) == "Four");
+    REQUIRE(std::get<1>(serial.at(7)) == 3);
+
+    for (size_t setupThreads : {2, 3, 8}) {
+        REQUIRE(construct(setupThreads) == serial);
+    }
+}
+
+TEST_CASE("RandomEngine picks the engine of every Actor's RNG") {
+    auto construct = [&](const std::string& engine, size_t setupThreads) {
+        NodeSource ns(R"(
+        SchemaVersion: 2018-07-01
+        RandomSeed: 1234
+        RandomEngine: )" + engine + R"(
+        Actors:
+        - Name: Three
+          Type: Recording
+          Threads: 3
+        )",
+                      "");
+        constructed.clear();
+        genny::metrics::Registry metrics;
+        genny::Orchestrator orchestrator{};
+        auto cast = Cast{{"Recording", std::make_shared<DefaultActorProducer<RecordingActor>>()}};
+        WorkloadContext{ns.root(), metrics, orchestrator, mongoUri.data(), cast, {}, setupThreads};
+        return constructed;
+    };
+
+    // Actor i gets the i'th stream split from the workload's RNG.
+    auto expected = [](RandomEngine engine) {
+        DefaultRandom workload{v1::SelectableEngine{engine, 1234}};
+        std::vector<DefaultRandom::result_type> out;
+        for (int i = 0; i < 3; ++i) {
+            out.push_back(workload.split()());
+        }
+        return out;
+    };
+    auto firstValues = [](const Constructed& actors) {
+        std::vector<DefaultRandom::result_type> out;
+        for (auto&& [id, actor] : actors) {
+            out.push_back(std::get<2>(actor));
+        }
+        return out;
+    };
+
+    SECTION("Defaults to mt19937_64 seeded the way it always has been") {
+        DefaultRandom workload{1234};
+        std::vector<DefaultRandom::result_type> seeds{workload(), workload(), workload()};
+        std::vector<DefaultRandom::result_type> values;
+        for (auto seed : seeds) {
+            values.push_back(DefaultRandom{seed}());
+        }
+        REQUIRE(firstValues(construct("mt19937_64", 1)) == values);
+        REQUIRE(expected(RandomEngine::kMt19937_64) == values);
+    }
+
+    SECTION("xoshiro256pp and pcg64 give each Actor a jumped-ahead stream") {
+        const auto xoshiro = firstValues(construct("xoshiro256pp", 1));
+        REQUIRE(xoshiro == expected(RandomEngine::kXoshiro256pp));
+        REQUIRE(firstValues(construct("xoshiro256pp", 3)) == xoshiro);
+
+        const auto pcg = firstValues(construct("pcg64", 1));
+        REQUIRE(pcg == expected(RandomEngine::kPcg64));
+        REQUIRE(pcg != xoshiro);
+    }
+
+    SECTION("Unknown engines are rejected") {
+        REQUIRE_THROWS_WITH(construct("rand", 1), Matches("Unknown RandomEngine 'rand'.*"));
+    }
+}
+
+TEST_CASE("Actors from one ActorContext share what ActorContext::shared makes") {
+    NodeSource ns(R"(
+    SchemaVersion: 2018-07-01
+    Actors:
+    - Name: Shares
+      Type: Op
+      Threads: 3
+      Pool: {Count: 10}
+    )",
+                  "");
+
+    int made = 0;
+    std::vector<std::shared_ptr<const int>> got;
+    auto producer = std::make_shared<OpProducer>([&](ActorContext& context) {
+        for (int i = 0; i < context.instanceCount(); ++i) {
+            got.push_back(context.shared<const int>(context["Pool"], [&]() {
+                ++made;
+                return std::make_shared<int>(context["Pool"]["Count"].to<int>());
+            }));
+        }
+    });
+
+    genny::metrics::Registry metrics;
+    genny::Orchestrator orchestrator{};
+    auto cast = Cast{{"Op", producer}};
+    WorkloadContext context{ns.root(), metrics, orchestrator, mongoUri.data(), cast};
+
+    REQUIRE(made == 1);
+    REQUIRE(got.size() == 3);
+    REQUIRE(*got[0] == 10);
+    REQUIRE(got[0] == got[1]);
+    REQUIRE(got[1] == got[2]);
+}
+
+TEST_CASE("Serial producers before parallelized ones don't change ids or RNGs") {
+    auto yaml = [](const std::string& first, const std::string& rest) {
+        std::ostringstream out;
+        out << "SchemaVersion: 2018-07-01\n"
+            << "RandomSeed: 1234\n"
+            << "Actors:\n"
+            << "- {Name: Two, Type: " << first << ", Threads: 2}\n"
+            << "- {Name: Three, Type: " << rest << ", Threads: 3}\n"
+            << "- {Name: One, Type: " << first << "}\n"
+            << "- {Name: Four, Type: " << rest << ", Threads: 4}\n";
+        return out.str();
+    };
+
+    auto construct = [&](const std::string& config, size_t setupThreads) {
+        NodeSource ns(config, "");
+        constructed.clear();
+        genny::metrics::Registry metrics;
+        genny::Orchestrator orchestrator{};
+        auto cast = Cast{
+            {"Recording", std::make_shared<DefaultActorProducer<RecordingActor>>()},
+            {"SerialRecording", std::make_shared<SerialRecordingProducer>()},
+        };
+        auto context = WorkloadContext{
+            ns.root(), metrics, orchestrator, mongoUri.data(), cast, {}, setupThreads};
+        REQUIRE(std::distance(context.actors().begin(), context.actors().end()) == 10);
+        return constructed;
+    };
+
+    // Every Actor constructed one after the other in the order they're configured.
+    const auto sequential = construct(yaml("SerialRecording", "SerialRecording"), 1);
+    REQUIRE(sequential.size() == 10);
+    REQUIRE(std::get<0>(sequential.at(0)) == "Two");
+    REQUIRE(std::get<0>(sequential.at(2)) == "Three");
+    REQUIRE(std::get<0>(sequential.at(5)) == "One");
+    REQUIRE(std::get<0>(sequential.at(6)) == "Four");
+    REQUIRE(std::get<1>(sequential.at(9)) == 3);
+
+    for (size_t setupThreads : {1, 2, 3, 8}) {
+        REQUIRE(construct(yaml("SerialRecording", "Recording"), setupThreads) == sequential);
+        REQUIRE(construct(yaml("Recording", "SerialRecording"), setupThreads) == sequential);
+    }
+}
@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <mutex>
 #include <thread>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/log/trivial.hpp>
 
@@ -182,6 +185,114 @@ TEST_CASE("Set minimum number of phases") {
     REQUIRE(o.currentPhase() == 3);
 }
 
+TEST_CASE("Parked tokens let phases start without some actors") {
+    genny::Orchestrator o{};
+    o.addRequiredTokens(2);
+    o.phasesAtLeastTo(2);
+    // The second actor sits out phase 1 and both sit out phase 2.
+    o.addParkedTokens(1);
+    o.addParkedTokens(2, 2);
+
+    std::atomic<int> phaseOneStarted = 0;
+    auto first = std::thread([&]() {
+        o.awaitPhaseStart();
+        o.awaitPhaseEnd();
+        o.awaitPhaseStart();
+        ++phaseOneStarted;
+        o.awaitPhaseEnd();
+        o.parkThroughPhase(2);
+    });
+    auto second = std::thread([&]() {
+        o.awaitPhaseStart();
+        o.awaitPhaseEnd();
+        o.parkThroughPhase(1);
+        {
+            std::unique_lock<std::mutex> lk(asserting);
+            REQUIRE(phaseOneStarted == 1);
+        }
+        // Nobody takes part in phase 2 so the parked actors end it themselves.
+        auto more = o.parkThroughPhase(2);
+        {
+            std::unique_lock<std::mutex> lk(asserting);
+            REQUIRE(!more);
+        }
+    });
+    first.join();
+    second.join();
+
+    REQUIRE(!o.morePhases());
+    REQUIRE(o.currentPhase() == 3);
+}
+
+TEST_CASE("Blocking pre-phase-start hooks don't hold the lock") {
+    genny::Orchestrator o{};
+    o.addRequiredTokens(1);
+    o.phasesAtLeastTo(1);
+
+    std::atomic<bool> inHook = false;
+    std::atomic<bool> release = false;
+    std::vector<std::string> calls;
+    o.addBlockingPrePhaseStartHook([&](const Orchestrator*) {
+        calls.push_back("blocking");
+        inHook = true;
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+    o.addPrePhaseStartHook([&](const Orchestrator*) { calls.push_back("locked"); });
+
+    auto starter = std::thread([&]() { o.awaitPhaseStart(); });
+    while (!inHook) {
+        std::this_thread::sleep_for(1ms);
+    }
+    // These would wait for the hook if it held the lock.
+    REQUIRE(o.currentPhase() == 0);
+    REQUIRE(o.morePhases());
+
+    release = true;
+    starter.join();
+    REQUIRE(calls == std::vector<std::string>{"blocking", "locked"});
+    o.awaitPhaseEnd();
+}
+
+TEST_CASE("Sleeping in a phase wakes up when the phase ends") {
+    genny::Orchestrator o{};
+    o.addRequiredTokens(1);
+    o.phasesAtLeastTo(1);
+    o.awaitPhaseStart();
+
+    SECTION("Full sleep if the phase doesn't end") {
+        REQUIRE(o.sleepInPhase(0, 1ms));
+    }
+
+    SECTION("No sleep if the phase is already over") {
+        o.awaitPhaseEnd(false);
+        auto start = steady_clock::now();
+        REQUIRE(!o.sleepInPhase(0, 1h));
+        REQUIRE(steady_clock::now() - start < 1s);
+    }
+
+    SECTION("Phase ending interrupts the sleep") {
+        auto start = steady_clock::now();
+        auto ender = std::thread([&]() {
+            std::this_thread::sleep_for(10ms);
+            o.awaitPhaseEnd(false);
+        });
+        REQUIRE(!o.sleepInPhase(0, 1h));
+        ender.join();
+        REQUIRE(steady_clock::now() - start < 10s);
+    }
+
+    SECTION("Abort interrupts the sleep") {
+        auto aborter = std::thread([&]() {
+            std::this_thread::sleep_for(10ms);
+            o.abort();
+        });
+        REQUIRE(!o.sleepInPhase(0, 1h));
+        aborter.join();
+    }
+}
+
 TEST_CASE("Orchestrator") {
     genny::metrics::Registry metrics;
     genny::Orchestrator o{};
@@ -15,12 +15,16 @@
 #ifndef HEADER_1EB08DF5_3853_4277_8B3D_4542552B8154_INCLUDED
 #define HEADER_1EB08DF5_3853_4277_8B3D_4542552B8154_INCLUDED
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <optional>
 
 #include <boost/log/trivial.hpp>
 
 #include <metrics/metrics.hpp>
+#include <metrics/v1/LatencySketch.hpp>
 
 namespace genny::metrics {
 
@@ -106,6 +110,42 @@ public:
         BOOST_LOG_TRIVIAL(debug) << "Finished metrics reporting.";
     }
 
+    /**
+     * Summarize the latencies of every actor operation that finished within a window of time.
+     * Used by drivers that need to make decisions based on in-process latency percentiles
+     * rather than by post-processing the report.
+     *
+     * @param from the (inclusive) start of the window.
+     * @param to the (inclusive) end of the window.
+     * @return a sketch of the durations of all operations that finished in `[from, to]`.
+     */
+    LatencySketch sketchLatencies(const typename MetricsClockSource::time_point& from,
+                                  const typename MetricsClockSource::time_point& to) const {
+        v1::Permission perm;
+        LatencySketch out;
+        for (const auto& [actorName, opsByType] : _registry->getOps(perm)) {
+            if (actorName == "Genny") {
+                // Driver-internal metrics aren't operations against the system under test.
+                continue;
+            }
+            for (const auto& [opName, opsByThread] : opsByType) {
+                for (const auto& [actorId, op] : opsByThread) {
+                    const auto excluded = _registry->getExcludedWindows(perm, actorName, actorId);
+                    for (const auto& event : op.getEvents()) {
+                        if (event.first < from || event.first > to ||
+                            isExcluded(excluded, event.first)) {
+                            continue;
+                        }
+                        out.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    static_cast<duration>(event.second.duration)),
+                                std::max<count_type>(event.second.iters, 1));
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
 private:
     using duration = typename MetricsClockSource::duration;
 
@@ -117,6 +157,10 @@ private:
         writeClocks(out, systemTime, metricsTime);
         out << std::endl;
 
+        writePlacements(out, perm);
+        writeWorkerPlacements(out, perm);
+        writePerfCounters(out, perm);
+
         out << "Counters" << std::endl;
         writeGennyActiveActorsMetric(out, perm);
         writeMetricValuesLegacy(
@@ -152,6 +196,99 @@ private:
             << "," << metricsTime << std::endl;
     }
 
+    // Only written when the driver pinned Actor threads to CPUs.
+    void writePlacements(std::ostream& out, v1::Permission perm) const {
+        const auto& placements = _registry->getPlacements(perm);
+        if (placements.empty()) {
+            return;
+        }
+        out << "Placement" << std::endl;
+        out << "thread,cpu,numa_node" << std::endl;
+        for (const auto& [actorId, placement] : placements) {
+            out << actorId << ",";
+            out << placement.cpu << ",";
+            out << placement.numaNode << std::endl;
+        }
+        out << std::endl;
+    }
+
+    // Only written when the driver pinned fiber worker threads to CPUs.
+    void writeWorkerPlacements(std::ostream& out, v1::Permission perm) const {
+        const auto& placements = _registry->getWorkerPlacements(perm);
+        if (placements.empty()) {
+            return;
+        }
+        out << "WorkerPlacement" << std::endl;
+        out << "worker,cpu,numa_node" << std::endl;
+        for (const auto& [worker, placement] : placements) {
+            out << worker << ",";
+            out << placement.cpu << ",";
+            out << placement.numaNode << std::endl;
+        }
+        out << std::endl;
+    }
+
+    // Only written when the driver was run with --perf-counters and some counters could be
+    // opened. A row per sampling window followed by the totals for each thread and phase.
+    void writePerfCounters(std::ostream& out, v1::Permission perm) const {
+        const auto samples = _registry->getPerfSamples(perm);
+        if (samples.empty()) {
+            return;
+        }
+        using Sample = typename RegistryT<MetricsClockSource>::PerfSample;
+
+        out << "PerfCounters" << std::endl;
+        out << "timestamp,thread,phase,cycles,instructions,cache_misses,context_switches"
+            << std::endl;
+        std::map<std::pair<ActorId, PhaseNumber>, Sample> totals;
+        for (const auto& sample : samples) {
+            out << nanosecondsCount(sample.when.time_since_epoch()) << ",";
+            out << sample.actorId << ",";
+            out << sample.phase << ",";
+            writePerfCounterValues(out, sample);
+
+            auto [it, inserted] = totals.try_emplace({sample.actorId, sample.phase}, sample);
+            if (!inserted) {
+                auto& total = it->second;
+                addCount(total.cycles, sample.cycles);
+                addCount(total.instructions, sample.instructions);
+                addCount(total.cacheMisses, sample.cacheMisses);
+                addCount(total.contextSwitches, sample.contextSwitches);
+            }
+        }
+        out << std::endl;
+
+        out << "PerfCountersByPhase" << std::endl;
+        out << "thread,phase,cycles,instructions,cache_misses,context_switches" << std::endl;
+        for (const auto& [key, total] : totals) {
+            out << key.first << ",";
+            out << key.second << ",";
+            writePerfCounterValues(out, total);
+        }
+        out << std::endl;
+    }
+
+    template <typename Sample>
+    static void writePerfCounterValues(std::ostream& out, const Sample& sample) {
+        // Counters that couldn't be opened are left blank rather than reported as zero.
+        const auto value = [&](const std::optional<count_type>& count) -> std::ostream& {
+            if (count) {
+                out << *count;
+            }
+            return out;
+        };
+        value(sample.cycles) << ",";
+        value(sample.instructions) << ",";
+        value(sample.cacheMisses) << ",";
+        value(sample.contextSwitches) << std::endl;
+    }
+
+    static void addCount(std::optional<count_type>& total, const std::optional<count_type>& add) {
+        if (add) {
+            total = total.value_or(0) + *add;
+        }
+    }
+
     static std::ostream& writeMetricNameLegacy(std::ostream& out,
                                                ActorId actorId,
                                                const std::string& actorName,
@@ -177,7 +314,11 @@ private:
 
             for (const auto& [opName, opsByThread] : opsByType) {
                 for (const auto& [actorId, op] : opsByThread) {
+                    const auto excluded = _registry->getExcludedWindows(perm, actorName, actorId);
                     for (const auto& event : op.getEvents()) {
+                        if (isExcluded(excluded, event.first)) {
+                            continue;
+                        }
                         out << nanosecondsCount(event.first.time_since_epoch());
                         out << ",";
                         writeMetricNameLegacy(out, actorId, actorName, opName) << suffix;
@@ -280,6 +421,10 @@ private:
         writeClocks(out, systemTime, metricsTime);
         out << std::endl;
 
+        writePlacements(out, perm);
+        writeWorkerPlacements(out, perm);
+        writePerfCounters(out, perm);
+
         // We use an ordered map here to avoid defining a custom hash function for
         // std::pair<std::string, std::string>. There aren't likely to be many (Actor, Operation)
         // combinations for this to matter too much in terms of efficiency.
@@ -314,7 +459,11 @@ private:
                 }
 
                 for (const auto& [actorId, op] : opsByThread) {
+                    const auto excluded = _registry->getExcludedWindows(perm, actorName, actorId);
                     for (const auto& event : op.getEvents()) {
+                        if (isExcluded(excluded, event.first)) {
+                            continue;
+                        }
                         out << nanosecondsCount(event.first.time_since_epoch()) << ",";
                         out << actorName << ",";
                         out << actorId << ",";
@@ -334,6 +483,23 @@ private:
         }
     }
 
+    using ExcludedWindows = typename RegistryT<MetricsClockSource>::ExcludedWindows;
+
+    // Checks if an event happened during a warmup or cooldown window.
+    static bool isExcluded(const ExcludedWindows& windows,
+                           const typename MetricsClockSource::time_point& when) {
+        if (windows.empty()) {
+            return false;
+        }
+        // The windows are sorted and don't overlap so only the last one starting
+        // at or before `when` can contain it.
+        auto it = std::upper_bound(
+            windows.begin(), windows.end(), when, [](const auto& time, const auto& window) {
+                return time < window.first;
+            });
+        return it != windows.begin() && when <= std::prev(it)->second;
+    }
+
     static bool shouldSkipReporting(const std::string& actorName, const std::string& opName) {
         // The cedar-csv metrics format ignores the Genny.ActorStarted and Genny.ActorFinished
         // operations reported by the DefaultDriver because the OperationThreadCounts section
@@ -15,10 +15,16 @@
 #ifndef HEADER_058638D3_7069_42DC_809F_5DB533FCFBA3_INCLUDED
 #define HEADER_058638D3_7069_42DC_809F_5DB533FCFBA3_INCLUDED
 
+#include <algorithm>
 #include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <gennylib/conventions.hpp>
 
@@ -82,10 +88,40 @@ private:
 
 public:
     using clock = ClockSource;
+    using ExcludedWindows =
+        std::vector<std::pair<typename ClockSource::time_point, typename ClockSource::time_point>>;
+
+    /**
+     * Where an Actor's thread was pinned to.
+     */
+    struct Placement {
+        int cpu;
+        int numaNode;
+    };
+    using Placements = std::map<ActorId, Placement>;
+    // Keyed by worker index rather than ActorId since fibers move between workers.
+    using WorkerPlacements = std::map<size_t, Placement>;
+
+    /**
+     * What the CPU did on behalf of one Actor thread during a window of time. Counters
+     * the kernel wouldn't let us open are left empty.
+     */
+    struct PerfSample {
+        // The end of the window.
+        typename ClockSource::time_point when;
+        ActorId actorId;
+        PhaseNumber phase;
+        std::optional<count_type> cycles;
+        std::optional<count_type> instructions;
+        std::optional<count_type> cacheMisses;
+        std::optional<count_type> contextSwitches;
+    };
+    using PerfSamples = std::vector<PerfSample>;
 
     explicit RegistryT() = default;
 
     OperationT<ClockSource> operation(std::string actorName, std::string opName, ActorId actorId) {
+        std::lock_guard<std::mutex> lk{*_opsMutex};
         auto& opsByType = this->_ops[actorName];
         auto& opsByThread = opsByType[opName];
         auto opIt = opsByThread.try_emplace(actorId, std::move(actorName), std::move(opName)).first;
@@ -97,6 +133,7 @@ public:
                                       ActorId actorId,
                                       genny::TimeSpec threshold,
                                       double_t percentage) {
+        std::lock_guard<std::mutex> lk{*_opsMutex};
         auto& opsByType = this->_ops[actorName];
         auto& opsByThread = opsByType[opName];
         auto opIt =
@@ -111,16 +148,116 @@ public:
         return OperationT{opIt->second};
     }
 
+    /**
+     * Leave out everything an Actor reports between `from` and `to` (inclusive) from the
+     * metrics output, e.g. because it is still warming up.
+     *
+     * Unlike the rest of the Registry, this may be called concurrently from multiple threads.
+     *
+     * @param actorName the name of the Actor, as passed to `operation()`.
+     * @param actorId the id of the Actor, as passed to `operation()`. The Actor's other
+     *                threads may still be measured during the window.
+     */
+    void excludeWindow(const std::string& actorName,
+                       ActorId actorId,
+                       typename ClockSource::time_point from,
+                       typename ClockSource::time_point to) {
+        std::lock_guard<std::mutex> lk{*_excludedWindowsMutex};
+        _excludedWindows[actorName][actorId].emplace_back(from, to);
+    }
+
+    /**
+     * Record which CPU an Actor's thread is pinned to so the placement shows up
+     * in the metrics output.
+     */
+    void recordPlacement(ActorId actorId, int cpu, int numaNode) {
+        _placements[actorId] = Placement{cpu, numaNode};
+    }
+
+    /**
+     * Record which CPU a fiber worker thread is pinned to. With `--execution fibers` Actors
+     * aren't tied to a thread so only the workers have a placement.
+     */
+    void recordWorkerPlacement(size_t worker, int cpu, int numaNode) {
+        _workerPlacements[worker] = Placement{cpu, numaNode};
+    }
+
+    /**
+     * Record hardware performance counters for an Actor thread (see `--perf-counters`).
+     *
+     * Unlike the rest of the Registry, this may be called concurrently from multiple threads.
+     */
+    void recordPerfSample(PerfSample sample) {
+        std::lock_guard<std::mutex> lk{*_perfSamplesMutex};
+        _perfSamples.push_back(std::move(sample));
+    }
+
     [[nodiscard]] const OperationsMap& getOps(Permission) const {
         return this->_ops;
     };
 
+    /**
+     * @return the windows of time passed to `excludeWindow()` for an Actor, sorted
+     *         by start time and with overlapping windows merged.
+     */
+    [[nodiscard]] ExcludedWindows getExcludedWindows(Permission,
+                                                     const std::string& actorName,
+                                                     ActorId actorId) const {
+        ExcludedWindows out;
+        {
+            std::lock_guard<std::mutex> lk{*_excludedWindowsMutex};
+            if (auto byName = _excludedWindows.find(actorName);
+                byName != _excludedWindows.end()) {
+                if (auto byId = byName->second.find(actorId); byId != byName->second.end()) {
+                    out = byId->second;
+                }
+            }
+        }
+        std::sort(out.begin(), out.end());
+
+        // A short phase's Warmup and Cooldown can overlap, merging them keeps lookups cheap.
+        ExcludedWindows merged;
+        for (const auto& window : out) {
+            if (!merged.empty() && window.first <= merged.back().second) {
+                merged.back().second = std::max(merged.back().second, window.second);
+            } else {
+                merged.push_back(window);
+            }
+        }
+        return merged;
+    }
+
+    [[nodiscard]] const Placements& getPlacements(Permission) const {
+        return _placements;
+    }
+
+    [[nodiscard]] const WorkerPlacements& getWorkerPlacements(Permission) const {
+        return _workerPlacements;
+    }
+
+    [[nodiscard]] PerfSamples getPerfSamples(Permission) const {
+        std::lock_guard<std::mutex> lk{*_perfSamplesMutex};
+        return _perfSamples;
+    }
+
     [[nodiscard]] const typename ClockSource::time_point now(Permission) const {
         return ClockSource::now();
     }
 
 private:
     OperationsMap _ops;
+    // Actors may be constructed (and register their operations) on several threads.
+    std::unique_ptr<std::mutex> _opsMutex = std::make_unique<std::mutex>();
+
+    // Behind a pointer so the Registry stays movable.
+    std::unique_ptr<std::mutex> _excludedWindowsMutex = std::make_unique<std::mutex>();
+    std::unordered_map<std::string, std::unordered_map<ActorId, ExcludedWindows>> _excludedWindows;
+
+    Placements _placements;
+    WorkerPlacements _workerPlacements;
+
+    std::unique_ptr<std::mutex> _perfSamplesMutex = std::make_unique<std::mutex>();
+    PerfSamples _perfSamples;
 };
 
 }  // namespace v1
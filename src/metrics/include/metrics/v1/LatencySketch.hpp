@@ -0,0 +1,176 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_4C0B3A5E_5D0F_4C8E_9F57_2E4B1C7F9A61_INCLUDED
+#define HEADER_4C0B3A5E_5D0F_4C8E_9F57_2E4B1C7F9A61_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace genny::metrics::v1 this namespace is private and only intended to be used by genny's
+ * own internals. No types from the genny::metrics::v1 namespace should ever be typed directly into
+ * the implementation of an actor.
+ */
+namespace genny::metrics::v1 {
+
+/**
+ * A fixed-size, log-linear histogram of latencies that can answer quantile
+ * queries (e.g. p99) without retaining every data-point.
+ *
+ * Values below 2^kSubBucketBits nanoseconds are counted exactly. Larger values
+ * are grouped by power-of-two and then split into 2^kSubBucketBits linear
+ * sub-buckets, so any reported quantile is within ~1.6% of the true value.
+ *
+ * Recording is a handful of integer operations and never allocates, so
+ * a sketch may be fed from a hot loop. Sketches are thread-compatible but not
+ * thread-safe; use one per thread and merge() them when reading.
+ */
+class LatencySketch final {
+public:
+    using count_type = int64_t;
+
+    LatencySketch() : _counts(kBucketCount, 0) {}
+
+    /**
+     * Record `n` occurrences of a latency.
+     */
+    void add(std::chrono::nanoseconds latency, count_type n = 1) {
+        const auto ns = latency.count() < 0 ? 0 : static_cast<uint64_t>(latency.count());
+        _counts[bucketFor(ns)] += n;
+        _count += n;
+    }
+
+    /**
+     * Add all the data-points from another sketch to this one.
+     */
+    void merge(const LatencySketch& other) {
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            _counts[i] += other._counts[i];
+        }
+        _count += other._count;
+    }
+
+    /**
+     * Forget all recorded data-points.
+     */
+    void clear() {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _count = 0;
+    }
+
+    /**
+     * @return number of data-points recorded.
+     */
+    count_type count() const {
+        return _count;
+    }
+
+    /**
+     * @param q quantile in [0, 1], e.g. 0.99 for p99.
+     * @return
+     *   the (approximate) latency at quantile `q`, or zero if no data-points
+     *   have been recorded.
+     */
+    std::chrono::nanoseconds quantile(double q) const {
+        if (q < 0 || q > 1) {
+            throw std::invalid_argument("Quantile must be between 0 and 1");
+        }
+        if (_count == 0) {
+            return std::chrono::nanoseconds{0};
+        }
+        return atRank(
+            std::max<count_type>(1, static_cast<count_type>(std::ceil(q * double(_count)))));
+    }
+
+    /**
+     * A distribution-free confidence interval for a quantile. The number of data-points
+     * below the true quantile is binomially distributed, which we approximate with a
+     * normal distribution to pick the ranks bounding the interval.
+     *
+     * @param q quantile in [0, 1], e.g. 0.99 for p99.
+     * @param z
+     *   number of standard deviations to include on either side. The default gives a
+     *   95% confidence interval.
+     * @return
+     *   the (approximate) lower and upper bounds or `nullopt` if there aren't enough
+     *   data-points to bound the quantile on both sides.
+     */
+    std::optional<std::pair<std::chrono::nanoseconds, std::chrono::nanoseconds>>
+    quantileConfidenceInterval(double q, double z = 1.96) const {
+        if (q < 0 || q > 1) {
+            throw std::invalid_argument("Quantile must be between 0 and 1");
+        }
+        const auto n = double(_count);
+        const auto spread = z * std::sqrt(n * q * (1 - q));
+        const auto lower = static_cast<count_type>(std::floor(n * q - spread));
+        const auto upper = static_cast<count_type>(std::ceil(n * q + spread));
+        if (_count == 0 || lower < 1 || upper > _count) {
+            return std::nullopt;
+        }
+        return std::make_pair(atRank(lower), atRank(upper));
+    }
+
+private:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+    // One exact group for [0, kSubBucketCount) and one group per remaining power of two.
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+    static size_t bucketFor(uint64_t ns) {
+        if (ns < kSubBucketCount) {
+            return ns;
+        }
+        const int exponent = 63 - __builtin_clzll(ns);
+        const int shift = exponent - kSubBucketBits;
+        const auto sub = (ns >> shift) - kSubBucketCount;
+        return (shift + 1) * kSubBucketCount + sub;
+    }
+
+    // The value of the rank'th smallest data-point. Ranks start at 1.
+    std::chrono::nanoseconds atRank(count_type rank) const {
+        count_type seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += _counts[i];
+            if (seen >= rank) {
+                return std::chrono::nanoseconds{static_cast<int64_t>(valueFor(i))};
+            }
+        }
+        return std::chrono::nanoseconds{static_cast<int64_t>(valueFor(kBucketCount - 1))};
+    }
+
+    // Midpoint of the range of values that land in `bucket`.
+    static uint64_t valueFor(size_t bucket) {
+        if (bucket < kSubBucketCount) {
+            return bucket;
+        }
+        const int shift = int(bucket / kSubBucketCount) - 1;
+        const auto sub = bucket % kSubBucketCount;
+        const auto low = (kSubBucketCount + sub) << shift;
+        return low + ((uint64_t{1} << shift) >> 1);
+    }
+
+    std::vector<count_type> _counts;
+    count_type _count = 0;
+};
+
+}  // namespace genny::metrics::v1
+
+#endif  // HEADER_4C0B3A5E_5D0F_4C8E_9F57_2E4B1C7F9A61_INCLUDED
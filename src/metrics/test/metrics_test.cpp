@@ -14,6 +14,9 @@
 
 #include <iomanip>
 #include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include <metrics/MetricsReporter.hpp>
 #include <metrics/metrics.hpp>
@@ -250,6 +253,76 @@ TEST_CASE("metrics output format") {
         reporter.report<ReporterClockSourceStub>(out, "cedar-csv");
         REQUIRE(out.str() == expected);
     }
+
+    SECTION("Excluded windows aren't reported") {
+        using time_point = RegistryClockSourceStub::time_point;
+        // Overlapping windows from the same thread.
+        metrics.excludeWindow("InsertRemove", 1, time_point{27ns}, time_point{29ns});
+        metrics.excludeWindow("InsertRemove", 1, time_point{28ns}, time_point{30ns});
+        metrics.excludeWindow("InsertRemove", 1, time_point{44ns}, time_point{50ns});
+        metrics.excludeWindow("InsertRemove", 2, time_point{29ns}, time_point{31ns});
+        // Only applies to the named actor.
+        metrics.excludeWindow("NotReported", 2, time_point{0ns}, time_point{50ns});
+
+        auto expected =
+            "Clocks\n"
+            "clock,nanoseconds\n"
+            "SystemTime,42000000\n"
+            "MetricsTime,45\n"
+            "\n"
+            "OperationThreadCounts\n"
+            "actor,operation,workers\n"
+            "HelloWorld,Greetings,1\n"
+            "HelloWorld,Synthetic,1\n"
+            "InsertRemove,Insert,2\n"
+            "InsertRemove,Remove,2\n"
+            "\n"
+            "Operations\n"
+            "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n"
+            "5,HelloWorld,4,Synthetic,300000,0,3,1,2,4\n"
+            "26,HelloWorld,3,Greetings,13,0,2,0,0,0\n"
+            "42,InsertRemove,2,Remove,10,0,1,7,0,30\n";
+
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "cedar-csv");
+        REQUIRE(out.str() == expected);
+    }
+
+    SECTION("Excluded windows only apply to their own thread") {
+        using time_point = RegistryClockSourceStub::time_point;
+        // The threads' phases are staggered: thread 1 is still warming up while thread
+        // 2 is measured and thread 2 is cooling down while thread 1 is measured.
+        metrics.excludeWindow("InsertRemove", 1, time_point{0ns}, time_point{35ns});
+        metrics.excludeWindow("InsertRemove", 2, time_point{40ns}, time_point{50ns});
+
+        auto expected =
+            "Clocks\n"
+            "clock,nanoseconds\n"
+            "SystemTime,42000000\n"
+            "MetricsTime,45\n"
+            "\n"
+            "OperationThreadCounts\n"
+            "actor,operation,workers\n"
+            "HelloWorld,Greetings,1\n"
+            "HelloWorld,Synthetic,1\n"
+            "InsertRemove,Insert,2\n"
+            "InsertRemove,Remove,2\n"
+            "\n"
+            "Operations\n"
+            "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n"
+            "5,HelloWorld,4,Synthetic,300000,0,3,1,2,4\n"
+            "26,HelloWorld,3,Greetings,13,0,2,0,0,0\n"
+            "45,InsertRemove,1,Remove,17,0,1,6,0,40\n"
+            "30,InsertRemove,2,Insert,20,0,1,8,0,200\n";
+
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "cedar-csv");
+        REQUIRE(out.str() == expected);
+
+        const auto sketch = reporter.sketchLatencies(time_point{0ns}, time_point{50ns});
+        // Synthetic and Greetings count 3 and 2 iterations, the measured Insert and Remove 1.
+        REQUIRE(sketch.count() == 3 + 2 + 1 + 1);
+    }
 }
 
 TEST_CASE("Genny.Setup metric") {
@@ -306,6 +379,134 @@ TEST_CASE("Genny.Setup metric") {
     }
 }
 
+TEST_CASE("Actor placement is reported") {
+    RegistryClockSourceStub::reset();
+    auto metrics = v1::RegistryT<RegistryClockSourceStub>{};
+    auto reporter = genny::metrics::v1::ReporterT{metrics};
+
+    // Mimic what the DefaultDriver does with --cpu-affinity.
+    metrics.recordPlacement(2u, 9, 1);
+    metrics.recordPlacement(1u, 0, 0);
+
+    SECTION("csv reporting") {
+        auto expected =
+            "Clocks\n"
+            "SystemTime,42000000\n"
+            "MetricsTime,0\n"
+            "\n"
+            "Placement\n"
+            "thread,cpu,numa_node\n"
+            "1,0,0\n"
+            "2,9,1\n"
+            "\n"
+            "Counters\n"
+            "\n"
+            "Gauges\n"
+            "\n"
+            "Timers\n"
+            "\n";
+
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "csv");
+        REQUIRE(out.str() == expected);
+    }
+
+    SECTION("cedar-csv reporting") {
+        auto expected =
+            "Clocks\n"
+            "clock,nanoseconds\n"
+            "SystemTime,42000000\n"
+            "MetricsTime,0\n"
+            "\n"
+            "Placement\n"
+            "thread,cpu,numa_node\n"
+            "1,0,0\n"
+            "2,9,1\n"
+            "\n"
+            "OperationThreadCounts\n"
+            "actor,operation,workers\n"
+            "\n"
+            "Operations\n"
+            "timestamp,actor,thread,operation,duration,outcome,n,ops,errors,size\n";
+
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "cedar-csv");
+        REQUIRE(out.str() == expected);
+    }
+}
+
+TEST_CASE("Fiber worker placement is reported") {
+    RegistryClockSourceStub::reset();
+    auto metrics = v1::RegistryT<RegistryClockSourceStub>{};
+    auto reporter = genny::metrics::v1::ReporterT{metrics};
+
+    // Mimic what the DefaultDriver does with --cpu-affinity and --execution fibers.
+    metrics.recordWorkerPlacement(1, 4, 1);
+    metrics.recordWorkerPlacement(0, 0, 0);
+
+    auto expected =
+        "Clocks\n"
+        "SystemTime,42000000\n"
+        "MetricsTime,0\n"
+        "\n"
+        "WorkerPlacement\n"
+        "worker,cpu,numa_node\n"
+        "0,0,0\n"
+        "1,4,1\n"
+        "\n"
+        "Counters\n"
+        "\n"
+        "Gauges\n"
+        "\n"
+        "Timers\n"
+        "\n";
+
+    std::ostringstream out;
+    reporter.report<ReporterClockSourceStub>(out, "csv");
+    REQUIRE(out.str() == expected);
+}
+
+TEST_CASE("Perf counters are reported") {
+    RegistryClockSourceStub::reset();
+    auto metrics = v1::RegistryT<RegistryClockSourceStub>{};
+    auto reporter = genny::metrics::v1::ReporterT{metrics};
+    using Sample = v1::RegistryT<RegistryClockSourceStub>::PerfSample;
+    using time_point = RegistryClockSourceStub::time_point;
+
+    // Mimic what the DefaultDriver does with --perf-counters on a VM without hardware counters.
+    metrics.recordPerfSample(Sample{time_point{10ns}, 1u, 0, {}, {}, {}, 3});
+    metrics.recordPerfSample(Sample{time_point{20ns}, 1u, 1, {}, {}, {}, 4});
+    metrics.recordPerfSample(Sample{time_point{30ns}, 1u, 1, {}, {}, {}, 5});
+    metrics.recordPerfSample(Sample{time_point{30ns}, 2u, 1, 1000, 2000, 7, 1});
+
+    const auto expected =
+        "PerfCounters\n"
+        "timestamp,thread,phase,cycles,instructions,cache_misses,context_switches\n"
+        "10,1,0,,,,3\n"
+        "20,1,1,,,,4\n"
+        "30,1,1,,,,5\n"
+        "30,2,1,1000,2000,7,1\n"
+        "\n"
+        "PerfCountersByPhase\n"
+        "thread,phase,cycles,instructions,cache_misses,context_switches\n"
+        "1,0,,,,3\n"
+        "1,1,,,,9\n"
+        "2,1,1000,2000,7,1\n"
+        "\n";
+
+    SECTION("csv reporting") {
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "csv");
+        REQUIRE_THAT(out.str(), Catch::Matchers::Contains(expected));
+    }
+
+    SECTION("cedar-csv reporting") {
+        std::ostringstream out;
+        reporter.report<ReporterClockSourceStub>(out, "cedar-csv");
+        REQUIRE_THAT(out.str(), Catch::Matchers::Contains(expected));
+    }
+}
+
 TEST_CASE("Genny.ActiveActors metric") {
     RegistryClockSourceStub::reset();
     auto metrics = v1::RegistryT<RegistryClockSourceStub>{};
@@ -482,5 +683,116 @@ TEST_CASE("Phases can set metrics") {
     }
 }
 
+TEST_CASE("Phases can exclude warmup and cooldown from metrics") {
+    auto runWith = [](const std::vector<std::string>& phaseConfig) {
+        std::ostringstream config;
+        config << R"(
+        SchemaVersion: 2018-07-01
+        Database: test
+        Actors:
+        - Name: WarmupTest
+          Type: HelloWorld
+          Threads: 1
+          Phases:
+          - MetricsName: Phase1Metrics
+)";
+        for (const auto& line : phaseConfig) {
+            config << "            " << line << "\n";
+        }
+        NodeSource yaml(config.str(), "");
+
+        ActorHelper ah{yaml.root(), 1};
+        ah.run();
+        return std::string(ah.getMetricsOutput());
+    };
+
+    SECTION("Without warmup") {
+        REQUIRE_THAT(runWith({"Repeat: 3"}), Catch::Contains("Phase1Metrics_bytes,13"));
+    }
+
+    SECTION("Warmup longer than the phase") {
+        // The phase finishes well within the warmup so nothing is reported.
+        REQUIRE_THAT(runWith({"Repeat: 3", "Warmup: 1 hour"}),
+                     !Catch::Contains("Phase1Metrics"));
+    }
+
+    SECTION("Cooldown longer than the phase") {
+        REQUIRE_THAT(runWith({"Repeat: 3", "Cooldown: 1 hour"}),
+                     !Catch::Contains("Phase1Metrics"));
+    }
+
+    SECTION("Warmup and Cooldown must fit in the Duration") {
+        REQUIRE_THROWS_WITH(
+            runWith({"Duration: 10 milliseconds",
+                     "Warmup: 5 milliseconds",
+                     "Cooldown: 5 milliseconds"}),
+            Catch::Contains("Warmup and Cooldown must leave some of the Duration"));
+    }
+}
+
+TEST_CASE("LatencySketch quantiles") {
+    v1::LatencySketch sketch;
+    REQUIRE(sketch.quantile(0.99) == 0ns);
+
+    SECTION("Small values are exact") {
+        for (int i = 1; i <= 50; ++i) {
+            sketch.add(std::chrono::nanoseconds{i});
+        }
+        REQUIRE(sketch.count() == 50);
+        REQUIRE(sketch.quantile(0) == 1ns);
+        REQUIRE(sketch.quantile(0.5) == 25ns);
+        REQUIRE(sketch.quantile(1) == 50ns);
+    }
+
+    SECTION("Large values are within a few percent") {
+        for (int i = 1; i <= 10000; ++i) {
+            sketch.add(std::chrono::microseconds{i});
+        }
+        for (auto q : {0.5, 0.9, 0.99}) {
+            const auto expected = 1000.0 * 10000 * q;
+            const auto actual = double(sketch.quantile(q).count());
+            REQUIRE(std::abs(actual - expected) / expected < 0.02);
+        }
+    }
+
+    SECTION("Weighted adds and merge") {
+        v1::LatencySketch other;
+        sketch.add(10ns, 99);
+        other.add(1s);
+        sketch.merge(other);
+
+        REQUIRE(sketch.count() == 100);
+        REQUIRE(sketch.quantile(0.99) == 10ns);
+        REQUIRE(std::abs(double(sketch.quantile(1).count()) - 1e9) / 1e9 < 0.02);
+
+        sketch.clear();
+        REQUIRE(sketch.count() == 0);
+    }
+
+    SECTION("Confidence intervals narrow with more data-points") {
+        REQUIRE(!sketch.quantileConfidenceInterval(0.99));
+
+        // Not enough data-points to bound p99 from above.
+        for (int i = 1; i <= 100; ++i) {
+            sketch.add(std::chrono::microseconds{i});
+        }
+        REQUIRE(!sketch.quantileConfidenceInterval(0.99));
+
+        for (int i = 1; i <= 100; ++i) {
+            sketch.add(std::chrono::microseconds{i}, 99);
+        }
+        const auto interval = sketch.quantileConfidenceInterval(0.99);
+        REQUIRE(interval);
+        REQUIRE(interval->first <= sketch.quantile(0.99));
+        REQUIRE(interval->second >= sketch.quantile(0.99));
+        REQUIRE(interval->second - interval->first < 5us);
+    }
+
+    SECTION("Rejects bad quantiles") {
+        REQUIRE_THROWS_AS(sketch.quantile(1.5), std::invalid_argument);
+        REQUIRE_THROWS_AS(sketch.quantileConfidenceInterval(-1), std::invalid_argument);
+    }
+}
+
 }  // namespace
 }  // namespace genny::metrics
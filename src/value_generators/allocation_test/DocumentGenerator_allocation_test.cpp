@@ -0,0 +1,141 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <new>
+
+#include <gennylib/Node.hpp>
+
+#include <value_generators/DefaultRandom.hpp>
+#include <value_generators/DocumentGenerator.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace {
+
+// Only counts allocations made on the thread that set it.
+thread_local bool countingAllocations = false;
+thread_local size_t allocations = 0;
+
+}  // namespace
+
+// Replacing the global operator new applies to the whole binary, which is why these tests
+// have one of their own. It only does any extra work on a thread that is counting.
+void* operator new(std::size_t size) {
+    if (countingAllocations) {
+        ++allocations;
+    }
+    if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace genny {
+namespace {
+
+/**
+ * @return how many times `f` allocated.
+ */
+template <typename F>
+size_t countAllocations(F&& f) {
+    allocations = 0;
+    countingAllocations = true;
+    f();
+    countingAllocations = false;
+    return allocations;
+}
+
+TEST_CASE("DocumentGenerator::evaluateInto allocations") {
+    genny::DefaultRandom rng;
+    NodeSource ns{R"(
+        a: 1
+        b: {^RandomInt: {min: 10, max: 1000}}
+        c:
+          d: [x, {^RandomString: {length: {^RandomInt: {min: 1, max: 300}}}}]
+          e: {^FastRandomString: {length: 100}}
+        f: {g: 1.5, h: [true, null]}
+    )",
+                  ""};
+    DocumentGenerator generator{ns.root(), rng};
+
+    SECTION("Doesn't allocate once the buffer is big enough") {
+        DocumentBuffer buffer;
+        // Long enough to have seen the longest ^RandomString.
+        for (int i = 0; i < 10000; ++i) {
+            generator.evaluateInto(buffer);
+        }
+
+        size_t length = 0;
+        auto count = countAllocations([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                length += generator.evaluateInto(buffer).length();
+            }
+        });
+        REQUIRE(length > 0);
+        REQUIRE(count == 0);
+    }
+
+    SECTION("evaluate allocates the document it returns") {
+        auto count = countAllocations([&]() { generator.evaluate(); });
+        REQUIRE(count > 0);
+    }
+}
+
+TEST_CASE("DocumentGenerator::generateBatch allocations") {
+    genny::DefaultRandom rng;
+    NodeSource ns{R"(
+        a: {^RandomInt: {min: 10, max: 1000}}
+        b: {^RandomString: {length: {^RandomInt: {min: 1, max: 300}}}}
+    )",
+                  ""};
+    DocumentGenerator generator{ns.root(), rng};
+    DocumentBatch batch;
+
+    SECTION("Doesn't allocate once the batch is big enough") {
+        for (int i = 0; i < 100; ++i) {
+            batch.clear();
+            generator.generateBatch(1000, batch);
+        }
+
+        auto count = countAllocations([&]() {
+            batch.clear();
+            generator.generateBatch(10, batch);
+        });
+        REQUIRE(count == 0);
+    }
+}
+
+TEST_CASE("Values copied from a shared slab allocations") {
+    genny::DefaultRandom rng;
+
+    SECTION("Don't allocate once the buffer is big enough") {
+        NodeSource nodeSource{"a: {^RandomBinary: {length: 100000}}", ""};
+        DocumentGenerator generator{nodeSource.root(), rng};
+        DocumentBuffer buffer;
+        generator.evaluateInto(buffer);
+        REQUIRE(countAllocations([&]() { generator.evaluateInto(buffer); }) == 0);
+    }
+}
+
+}  // namespace
+}  // namespace genny
@@ -0,0 +1,202 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <value_generators/DocumentGenerator.hpp>
+
+#include <testlib/findRepoRoot.hpp>
+#include <testlib/helpers.hpp>
+
+namespace genny {
+namespace {
+
+namespace fs = boost::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// How long to generate documents from each template for.
+constexpr auto kDuration = std::chrono::milliseconds{200};
+
+// Every `Document` template in a workload, e.g. those given to Loader and CrudActor.
+void findTemplates(const YAML::Node& node, std::vector<YAML::Node>& out) {
+    if (node.IsSequence()) {
+        for (const auto& child : node) {
+            findTemplates(child, out);
+        }
+    }
+    if (node.IsMap()) {
+        for (const auto& kvp : node) {
+            if (kvp.first.as<std::string>() == "Document" && kvp.second.IsMap()) {
+                out.push_back(kvp.second);
+            } else {
+                findTemplates(kvp.second, out);
+            }
+        }
+    }
+}
+
+struct Throughput {
+    int64_t docs = 0;
+    int64_t bytes = 0;
+    double seconds = 0;
+};
+
+Throughput generate(DocumentGenerator& generator) {
+    Throughput out;
+    const auto started = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (elapsed < kDuration) {
+        // Some templates make multi-MB documents so check the clock after every one.
+        const auto doc = generator();
+        ++out.docs;
+        out.bytes += doc.view().length();
+        elapsed = Clock::now() - started;
+    }
+    out.seconds = std::chrono::duration<double>(elapsed).count();
+    return out;
+}
+
+/**
+ * Documents per second generated from the `Document` templates of the scale workloads.
+ * Document generation is the main client-side cost of insert-heavy workloads.
+ */
+TEST_CASE("DocumentGenerator throughput on the scale workloads", "[benchmark]") {
+    const auto dir = fs::path{findRepoRoot()} / "src" / "workloads" / "scale";
+    std::vector<fs::path> workloads;
+    for (const auto& entry : fs::directory_iterator{dir}) {
+        if (entry.path().extension() == ".yml") {
+            workloads.push_back(entry.path());
+        }
+    }
+    std::sort(workloads.begin(), workloads.end());
+
+    for (const auto& workload : workloads) {
+        std::vector<YAML::Node> templates;
+        findTemplates(YAML::LoadFile(workload.string()), templates);
+
+        for (size_t i = 0; i < templates.size(); ++i) {
+            NodeSource nodeSource{YAML::Dump(templates[i]), workload.string()};
+            DefaultRandom rng;
+            DocumentGenerator generator{nodeSource.root(), rng};
+
+            const auto result = generate(generator);
+            REQUIRE(result.docs > 0);
+            BOOST_LOG_TRIVIAL(info)
+                << workload.filename().string() << " Document " << i << ": "
+                << int64_t(double(result.docs) / result.seconds) << " docs/s, "
+                << int64_t(double(result.bytes) / result.seconds / 1e6) << " MB/s";
+        }
+    }
+}
+
+/**
+ * How fast ^FastRandomString fills strings of different lengths. Large strings are mostly
+ * used to pad documents to a given size.
+ */
+TEST_CASE("FastRandomString throughput by length", "[benchmark]") {
+    for (int64_t length : {16, 256, 4 * 1024, 64 * 1024, 1024 * 1024}) {
+        NodeSource nodeSource{"a: {^FastRandomString: {length: " + std::to_string(length) + "}}",
+                              "FastRandomString"};
+        DefaultRandom rng;
+        DocumentGenerator generator{nodeSource.root(), rng};
+        DocumentBuffer buffer;
+
+        int64_t strings = 0;
+        const auto started = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < kDuration) {
+            generator.evaluateInto(buffer);
+            ++strings;
+            elapsed = Clock::now() - started;
+        }
+        const auto seconds = std::chrono::duration<double>(elapsed).count();
+
+        REQUIRE(strings > 0);
+        BOOST_LOG_TRIVIAL(info) << "FastRandomString length " << length << ": "
+                                << int64_t(double(strings) / seconds) << " strings/s, "
+                                << int64_t(double(strings * length) / seconds / 1e6) << " MB/s";
+    }
+}
+
+/**
+ * How much cheaper copying large values out of the shared slab is than filling them with
+ * ^FastRandomString.
+ */
+TEST_CASE("Slab payload throughput by length", "[benchmark]") {
+    for (const std::string meta : {"^FastRandomString", "^RandomSlabString", "^RandomBinary"}) {
+        for (int64_t length : {4 * 1024, 1024 * 1024, 15 * 1024 * 1024}) {
+            NodeSource nodeSource{
+                "a: {" + meta + ": {length: " + std::to_string(length) + "}}", meta};
+            DefaultRandom rng;
+            DocumentGenerator generator{nodeSource.root(), rng};
+            DocumentBuffer buffer;
+
+            int64_t values = 0;
+            const auto started = Clock::now();
+            auto elapsed = Clock::duration::zero();
+            while (elapsed < kDuration) {
+                generator.evaluateInto(buffer);
+                ++values;
+                elapsed = Clock::now() - started;
+            }
+            const auto seconds = std::chrono::duration<double>(elapsed).count();
+
+            REQUIRE(values > 0);
+            BOOST_LOG_TRIVIAL(info)
+                << meta << " length " << length << ": " << int64_t(double(values) / seconds)
+                << " values/s, " << int64_t(double(values * length) / seconds / 1e6) << " MB/s";
+        }
+    }
+}
+
+/**
+ * How long a skewed ^RandomInt takes per value as the range grows. It should stay flat up to
+ * ranges far larger than could be kept in memory.
+ */
+TEST_CASE("Skewed RandomInt cost by range", "[benchmark]") {
+    for (const std::string distribution :
+         {"distribution: zipfian", "distribution: hotspot, hotFraction: 0.1, hotOpFraction: 0.9"}) {
+        for (const std::string max : {"1000", "1000000", "1000000000", "1000000000000"}) {
+            NodeSource nodeSource{"a: {^RandomInt: {" + distribution + ", min: 0, max: " + max +
+                                      "}}",
+                                  "RandomInt"};
+            DefaultRandom rng;
+            DocumentGenerator generator{nodeSource.root(), rng};
+            DocumentBuffer buffer;
+
+            int64_t values = 0;
+            const auto started = Clock::now();
+            auto elapsed = Clock::duration::zero();
+            while (elapsed < kDuration) {
+                generator.evaluateInto(buffer);
+                ++values;
+                elapsed = Clock::now() - started;
+            }
+            const auto seconds = std::chrono::duration<double>(elapsed).count();
+
+            REQUIRE(values > 0);
+            BOOST_LOG_TRIVIAL(info) << "RandomInt " << distribution << " max " << max << ": "
+                                    << int64_t(seconds * 1e9 / double(values)) << " ns/value";
+        }
+    }
+}
+
+}  // namespace
+}  // namespace genny
@@ -17,12 +17,280 @@
 
 #include <cstdint>
 #include <memory>
+#include <random>
+#include <string>
+#include <variant>
 
 #include <boost/random.hpp>
 
 namespace genny {
+
+/**
+ * Which algorithm a DefaultRandom uses, set for a whole workload with its `RandomEngine` key.
+ */
+enum class RandomEngine {
+    /** The default. Gives the same values genny always has but has 2.5KB of state. */
+    kMt19937_64,
+    /** 32 bytes of state and the fastest draws. */
+    kXoshiro256pp,
+    /** 32 bytes of state. */
+    kPcg64,
+};
+
 namespace v1 {
 
+/**
+ * Used to turn one seed into the larger state of the other engines.
+ * @private
+ */
+inline uint64_t splitMix64(uint64_t& state) {
+    auto z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * xoshiro256++ from http://prng.di.unimi.it.
+ * @private
+ */
+class Xoshiro256pp {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256pp(result_type seed) {
+        this->seed(seed);
+    }
+
+    void seed(result_type seed) {
+        for (auto& word : _s) {
+            word = splitMix64(seed);
+        }
+    }
+
+    result_type operator()() {
+        const auto result = rotl(_s[0] + _s[3], 23) + _s[0];
+        const auto t = _s[1] << 17;
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+        _s[2] ^= t;
+        _s[3] = rotl(_s[3], 45);
+        return result;
+    }
+
+    /**
+     * Skip ahead 2^128 values.
+     */
+    void jump() {
+        static constexpr uint64_t kJump[] = {
+            0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+        uint64_t s[4] = {0, 0, 0, 0};
+        for (auto word : kJump) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (uint64_t{1} << b)) {
+                    for (int i = 0; i < 4; ++i) {
+                        s[i] ^= _s[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            _s[i] = s[i];
+        }
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t _s[4];
+};
+
+/**
+ * pcg64 (XSL RR 128/64) from http://www.pcg-random.org.
+ * @private
+ */
+class Pcg64 {
+public:
+    using result_type = uint64_t;
+    using uint128 = unsigned __int128;
+
+    // pcg-cpp's default stream. The increment it gives, `(stream << 1) | 1`, is pcg-cpp's
+    // default_increment.
+    static constexpr uint128 kDefaultStream =
+        ((uint128{6364136223846793005ull} << 64) | 1442695040888963407ull) >> 1;
+
+    explicit Pcg64(result_type seed) {
+        this->seed(seed);
+    }
+
+    /**
+     * Seed the way pcg-cpp does from a 128-bit state and stream. `pcg64{state}` in pcg-cpp
+     * is `Pcg64{state, kDefaultStream}`.
+     */
+    Pcg64(uint128 state, uint128 stream) {
+        _state = 0;
+        _inc = (stream << 1) | 1;
+        (*this)();
+        _state += state;
+        (*this)();
+    }
+
+    void seed(result_type seed) {
+        const uint128 high = splitMix64(seed);
+        const uint128 low = splitMix64(seed);
+        *this = Pcg64{(high << 64) | low, kDefaultStream};
+    }
+
+    result_type operator()() {
+        _state = _state * kMultiplier + _inc;
+        const auto rot = int(_state >> 122);
+        const auto xored = uint64_t(_state >> 64) ^ uint64_t(_state);
+        return (xored >> rot) | (xored << ((-rot) & 63));
+    }
+
+    /**
+     * Skip ahead 2^64 values.
+     */
+    void jump() {
+        advance(uint128{1} << 64);
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+private:
+    static constexpr uint128 kMultiplier =
+        (uint128{2549297995355413924ull} << 64) | 4865540595714422341ull;
+
+    // Brown's "Random Number Generation with Arbitrary Stride" in O(log delta).
+    void advance(uint128 delta) {
+        uint128 curMult = kMultiplier, curPlus = _inc, accMult = 1, accPlus = 0;
+        while (delta > 0) {
+            if (delta & 1) {
+                accMult *= curMult;
+                accPlus = accPlus * curMult + curPlus;
+            }
+            curPlus = (curMult + 1) * curPlus;
+            curMult *= curMult;
+            delta >>= 1;
+        }
+        _state = accMult * _state + accPlus;
+    }
+
+    uint128 _state;
+    uint128 _inc;
+};
+
+/**
+ * Any of the RandomEngine algorithms, picked when it's constructed.
+ *
+ * Every engine is kept inline rather than behind a pointer so a draw is a well-predicted
+ * branch and not an indirect call. Only the chosen engine's state is ever touched.
+ * @private
+ */
+class SelectableEngine {
+public:
+    using result_type = uint64_t;
+
+    explicit SelectableEngine(result_type seed) : _engine{std::in_place_index<0>, seed} {}
+
+    SelectableEngine(RandomEngine engine, result_type seed) : _engine{make(engine, seed)} {}
+
+    void seed(result_type seed) {
+        switch (_engine.index()) {
+            case 0:
+                return std::get_if<0>(&_engine)->seed(seed);
+            case 1:
+                return std::get_if<1>(&_engine)->seed(seed);
+            default:
+                return std::get_if<2>(&_engine)->seed(seed);
+        }
+    }
+
+    result_type operator()() {
+        switch (_engine.index()) {
+            case 0:
+                return (*std::get_if<0>(&_engine))();
+            case 1:
+                return (*std::get_if<1>(&_engine))();
+            default:
+                return (*std::get_if<2>(&_engine))();
+        }
+    }
+
+    /**
+     * @return an engine of the same kind whose values don't overlap with those drawn from
+     * this one or from any other stream split from it.
+     *
+     * mt19937_64 can't jump ahead cheaply so its streams are seeded by the next value drawn,
+     * which is how genny has always seeded the RNG of each Actor.
+     */
+    SelectableEngine split() {
+        auto out = *this;
+        switch (_engine.index()) {
+            case 0:
+                out.seed((*this)());
+                break;
+            case 1:
+                std::get_if<1>(&_engine)->jump();
+                break;
+            default:
+                std::get_if<2>(&_engine)->jump();
+                break;
+        }
+        return out;
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+private:
+    // Same order as RandomEngine.
+    using Engine = std::variant<boost::random::mt19937_64, Xoshiro256pp, Pcg64>;
+
+    static Engine make(RandomEngine engine, result_type seed) {
+        switch (engine) {
+            case RandomEngine::kXoshiro256pp:
+                return Engine{std::in_place_index<1>, seed};
+            case RandomEngine::kPcg64:
+                return Engine{std::in_place_index<2>, seed};
+            default:
+                return Engine{std::in_place_index<0>, seed};
+        }
+    }
+
+    Engine _engine;
+};
+
+// Boost's min() and max() aren't constexpr in every version, the standard library's
+// equivalent engine's are.
+static_assert(std::mt19937_64::min() == SelectableEngine::min() &&
+                  std::mt19937_64::max() == SelectableEngine::max(),
+              "All engines must give values over the same range");
+
 /**
  * Genny random number generator.
  *
@@ -44,6 +312,11 @@ public:
      */
     explicit Random(result_type seed = 6514393) : _rng(seed) {}
 
+    /**
+     * Construct a Random object that uses the given engine.
+     */
+    explicit Random(RNGImpl rng) : _rng(std::move(rng)) {}
+
     // Moves are okay
     Random(Random&&) noexcept = default;
     Random& operator=(Random&&) noexcept = default;
@@ -59,7 +332,9 @@ public:
      * @return
      */
     Random child() {
-        return Random(this->nextValue());
+        auto rng = _rng;
+        rng.seed(this->nextValue());
+        return Random(std::move(rng));
     }
 
     /**
@@ -69,6 +344,14 @@ public:
         _rng.seed(newSeed);
     }
 
+    /**
+     * Construct a new Random whose values don't overlap with this one's. See
+     * SelectableEngine::split().
+     */
+    Random split() {
+        return Random(_rng.split());
+    }
+
     /**
      * Generate random number.
      */
@@ -109,7 +392,7 @@ private:
  */
 // Note we use boost::random because its distributions are
 // cross-platform.
-using DefaultRandom = v1::Random<boost::random::mt19937_64>;
+using DefaultRandom = v1::Random<v1::SelectableEngine>;
 
 }  // namespace genny
 #endif  // HEADER_EBA231D0_AA7A_4008_A9E8_BD1C98D9023E_INCLUDED
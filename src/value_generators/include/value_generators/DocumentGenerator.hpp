@@ -15,11 +15,15 @@
 #ifndef HEADER_E6E05F14_BE21_4A9B_822D_FFD669CFB1B4_INCLUDED
 #define HEADER_E6E05F14_BE21_4A9B_822D_FFD669CFB1B4_INCLUDED
 
+#include <atomic>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
 
 #include <gennylib/Node.hpp>
 #include <gennylib/context.hpp>
@@ -36,11 +40,78 @@ public:
     using std::invalid_argument::invalid_argument;
 };
 
+/**
+ * Memory for DocumentGenerator::evaluateInto() to write documents into. It grows to fit the
+ * biggest document written into it and is never shrunk, so keeping one around between
+ * iterations means generating documents stops allocating once it's big enough.
+ */
+class DocumentBuffer {
+private:
+    friend class DocumentGenerator;
+    std::string _bytes;
+};
+
+/**
+ * Documents generated by DocumentGenerator::generateBatch() laid out one after the other in a
+ * single block of memory. Like DocumentBuffer its memory is kept by `clear()`, so reusing one
+ * batch for every insert stops allocating once it has held the biggest batch.
+ */
+class DocumentBatch {
+public:
+    /**
+     * Forget the documents but keep the memory they were in.
+     */
+    void clear() {
+        _bytes.clear();
+        _ends.clear();
+        _views.clear();
+    }
+
+    /**
+     * @return views of the documents in the order they were generated. They can be passed
+     * straight to `mongocxx::collection::insert_many()` and are valid until the batch is
+     * next written to.
+     */
+    const std::vector<bsoncxx::document::view>& views() const {
+        return _views;
+    }
+
+    size_t size() const {
+        return _views.size();
+    }
+
+    /**
+     * @return the total size in bytes of all the documents.
+     */
+    size_t bytes() const {
+        return _bytes.size();
+    }
+
+private:
+    friend class DocumentGenerator;
+    std::string _bytes;
+    // Where each document ends in _bytes.
+    std::vector<size_t> _ends;
+    std::vector<bsoncxx::document::view> _views;
+};
+
 class DocumentGenerator {
 public:
     explicit DocumentGenerator(const Node& node, PhaseContext& phaseContext, ActorId id);
     explicit DocumentGenerator(const Node& node, ActorContext& phaseContext, ActorId id);
     explicit DocumentGenerator(const Node& node, DefaultRandom& rng);
+    /**
+     * @param id the Actor the documents are for. `^Inc` uses it to give each Actor its own
+     * values. The other constructors use the id they're given, or 0.
+     * @param incCounter counts the `^Inc` values generated for the Actor. Generators that
+     * share it don't repeat each other's values. The context constructors use
+     * `ActorContext::incCounter(id)` and the others count on their own.
+     */
+    explicit DocumentGenerator(const Node& node,
+                               DefaultRandom& rng,
+                               ActorId id,
+                               std::atomic<uint64_t>& incCounter);
+    explicit DocumentGenerator(const Node& node, DefaultRandom& rng, ActorId id);
     /**
      * @return a document according to the template given by the node in the constructor.
      */
@@ -62,14 +133,86 @@ public:
      * @return
      */
     bsoncxx::document::value evaluate();
+    /**
+     * Same as `evaluate()` but writes the document into `buffer` instead of allocating it.
+     *
+     * ```c++
+     * // a member so it's reused every iteration
+     * DocumentBuffer _buffer;
+     * ...
+     * auto doc = docGen.evaluateInto(_buffer);
+     * ```
+     * @return a view of the document that is valid until `buffer` is next written to.
+     */
+    bsoncxx::document::view evaluateInto(DocumentBuffer& buffer);
+    /**
+     * Generate `n` documents and add them to the end of `batch`.
+     *
+     * ```c++
+     * batch.clear();
+     * collection.insert_many(docGen.generateBatch(1000, batch));
+     * ```
+     * @return all the documents in `batch`, including any that were there before.
+     */
+    const std::vector<bsoncxx::document::view>& generateBatch(size_t n, DocumentBatch& batch);
     DocumentGenerator(DocumentGenerator&&) noexcept;
     ~DocumentGenerator();
     class Impl;
 
 private:
+    DocumentGenerator(const Node& node,
+                      DefaultRandom& rng,
+                      ActorId id,
+                      std::atomic<uint64_t>* incCounter);
+
     std::unique_ptr<Impl> _impl;
 };
 
+/**
+ * Documents generated up front, so running a workload only has to pick one instead of
+ * generating it. Nothing changes it once it's made, so many threads can read one pool.
+ *
+ * Each entry holds one document from every generator the pool was made from, e.g. the
+ * `Documents` of an insertMany.
+ */
+class DocumentPool {
+public:
+    /**
+     * Generate `count` entries from `generators`. Throws if there would be no documents.
+     */
+    DocumentPool(std::vector<DocumentGenerator>& generators, size_t count);
+
+    // The views point into the pool so it can't be copied or moved.
+    DocumentPool(const DocumentPool&) = delete;
+    DocumentPool& operator=(const DocumentPool&) = delete;
+
+    /**
+     * @return the number of entries.
+     */
+    size_t size() const {
+        return _count;
+    }
+
+    /**
+     * @return the number of documents in each entry.
+     */
+    size_t width() const {
+        return _width;
+    }
+
+    /**
+     * @return the first of the `width()` documents in entry `i`.
+     */
+    const bsoncxx::document::view* operator[](size_t i) const {
+        return _batch.views().data() + i * _width;
+    }
+
+private:
+    DocumentBatch _batch;
+    size_t _count;
+    size_t _width;
+};
+
 }  // namespace genny
 
 #endif  // HEADER_E6E05F14_BE21_4A9B_822D_FFD669CFB1B4_INCLUDED
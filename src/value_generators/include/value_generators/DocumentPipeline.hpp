@@ -0,0 +1,188 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADER_0C6E3A8B_5F0D_4B8E_9A57_2E1D4C7B9F31_INCLUDED
+#define HEADER_0C6E3A8B_5F0D_4B8E_9A57_2E1D4C7B9F31_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/fiber/condition_variable.hpp>
+
+#include <gennylib/Node.hpp>
+
+#include <value_generators/DefaultRandom.hpp>
+#include <value_generators/DocumentGenerator.hpp>
+
+namespace genny {
+
+class DocumentPipeline;
+
+/**
+ * Documents generated ahead of time for one Actor thread by a DocumentPipeline thread.
+ *
+ * Exactly one pipeline thread writes to a ring and exactly one Actor thread reads from it,
+ * so handing a document over is a pair of atomic loads and stores. The Actor only sleeps
+ * when the ring is empty. Each slot keeps its memory, so once the slots have held their
+ * biggest documents nothing allocates.
+ *
+ * ```c++
+ * const auto& batch = ring.acquire();
+ * collection.insert_many(batch.views());
+ * ring.release();
+ * ```
+ */
+class DocumentRing {
+public:
+    /**
+     * @param templates the documents to generate. Each slot holds one document from each.
+     * @param rng only used by the pipeline thread, so it can't be shared with the Actor.
+     * @param id the Actor the documents are for.
+     * @param depth how many slots there are.
+     * @param incCounter the Actor's `^Inc` counter, see DocumentGenerator. If not given the
+     * ring's documents count on their own.
+     */
+    DocumentRing(const std::vector<const Node*>& templates,
+                 DefaultRandom rng,
+                 ActorId id,
+                 size_t depth,
+                 std::atomic<uint64_t>* incCounter = nullptr);
+
+    // Pipeline threads point at the ring.
+    DocumentRing(const DocumentRing&) = delete;
+    DocumentRing& operator=(const DocumentRing&) = delete;
+
+    /**
+     * Wait until a slot has been generated.
+     *
+     * @return the documents, which stay valid until `release()`.
+     */
+    const DocumentBatch& acquire() {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (_tail.load(std::memory_order_acquire) == head) {
+            waitForFill(head);
+        }
+        return _slots[head % _slots.size()];
+    }
+
+    /**
+     * Give the slot from `acquire()` back to be generated into again.
+     */
+    void release();
+
+    /**
+     * @return how many slots are generated and waiting to be acquired.
+     */
+    size_t ready() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return the number of slots.
+     */
+    size_t depth() const {
+        return _slots.size();
+    }
+
+private:
+    friend class DocumentPipeline;
+
+    /**
+     * Generate into the next free slot, if there is one. Only called by the pipeline thread.
+     * @return whether a slot was generated.
+     */
+    bool fill();
+
+    // Block until the pipeline thread fills slot `head`.
+    void waitForFill(size_t head);
+
+    DefaultRandom _rng;
+    std::atomic<uint64_t> _incCounter{0};
+    std::vector<DocumentGenerator> _generators;
+    std::vector<DocumentBatch> _slots;
+    DocumentPipeline* _pipeline = nullptr;
+
+    // The next slot to acquire and the next to fill. They only increase.
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+
+    // Fiber-aware so an Actor run on a fiber gives up its worker while it waits for a slot.
+    // It behaves like std::condition_variable_any when used from plain threads.
+    std::mutex _lock;
+    boost::fibers::condition_variable_any _filled;
+    std::atomic<bool> _waiting{false};
+};
+
+/**
+ * Threads that generate documents into DocumentRings so Actors don't spend their own time
+ * generating them.
+ *
+ * Each ring is filled by one of the threads. A thread with no free slot in any of its rings
+ * sleeps until an Actor releases one.
+ */
+class DocumentPipeline {
+public:
+    explicit DocumentPipeline(size_t threads);
+
+    // Stops and joins the threads.
+    ~DocumentPipeline();
+
+    DocumentPipeline(const DocumentPipeline&) = delete;
+    DocumentPipeline& operator=(const DocumentPipeline&) = delete;
+
+    /**
+     * Start generating into `ring`. A ring can only be added to one pipeline and can't be
+     * released from once the pipeline is destroyed.
+     */
+    void add(std::shared_ptr<DocumentRing> ring);
+
+private:
+    friend class DocumentRing;
+
+    struct Worker {
+        std::mutex lock;
+        std::vector<std::shared_ptr<DocumentRing>> rings;
+    };
+
+    void run(Worker& worker);
+
+    // Called by DocumentRing::release().
+    void wake() {
+        _releases.fetch_add(1);
+        if (_sleeping.load() > 0) {
+            std::lock_guard<std::mutex> lk{_lock};
+            _wake.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<size_t> _nextWorker{0};
+
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::atomic<bool> _stopping{false};
+    std::atomic<size_t> _releases{0};
+    std::atomic<size_t> _sleeping{0};
+
+    std::vector<std::thread> _threads;
+};
+
+}  // namespace genny
+
+#endif  // HEADER_0C6E3A8B_5F0D_4B8E_9A57_2E1D4C7B9F31_INCLUDED
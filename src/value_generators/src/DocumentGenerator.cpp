@@ -14,79 +14,335 @@
 
 #include <value_generators/DocumentGenerator.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <functional>
 #include <map>
+#include <random>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
 #include <boost/log/trivial.hpp>
 
-#include <bsoncxx/builder/basic/array.hpp>
-#include <bsoncxx/builder/basic/document.hpp>
-#include <bsoncxx/builder/basic/kvp.hpp>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <bsoncxx/types.hpp>
 
 
 namespace {
 
-class Appendable {
-public:
-    virtual ~Appendable() = default;
-    virtual void append(const std::string& key, bsoncxx::builder::basic::document& builder) = 0;
-    virtual void append(bsoncxx::builder::basic::array& builder) = 0;
-};
+// BSON is little-endian, as is every platform genny runs on, so numbers are copied as-is.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "BSON encoding assumes little-endian");
 
-using UniqueAppendable = std::unique_ptr<Appendable>;
+template <typename T>
+void appendRaw(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
 
 template <class T>
-class Generator : public Appendable {
+class Generator {
 public:
-    ~Generator() override = default;
+    virtual ~Generator() = default;
     virtual T evaluate() = 0;
-    void append(const std::string& key, bsoncxx::builder::basic::document& builder) override {
-        builder.append(bsoncxx::builder::basic::kvp(key, this->evaluate()));
-    }
-    void append(bsoncxx::builder::basic::array& builder) override {
-        builder.append(this->evaluate());
-    }
 };
 
 template <class T>
 using UniqueGenerator = std::unique_ptr<Generator<T>>;
 
+/**
+ * Generates strings straight into the document being written so they don't need to be
+ * allocated.
+ */
+class StringAppender {
+public:
+    virtual ~StringAppender() = default;
+    virtual void appendTo(std::string& out) = 0;
+};
+
+/**
+ * Like StringAppender but for values whose whole encoding is written by the generator, e.g.
+ * the 12 bytes of an ObjectId.
+ */
+class ValueAppender {
+public:
+    virtual ~ValueAppender() = default;
+    virtual void appendTo(std::string& out) = 0;
+};
+
 template <typename T>
-class ConstantAppender : public Generator<T> {
+class ConstantGenerator : public Generator<T> {
 public:
-    explicit ConstantAppender(T value) : _value{value} {}
-    explicit ConstantAppender() : _value{} {}
+    explicit ConstantGenerator(T value) : _value{value} {}
     T evaluate() override {
         return _value;
     }
 
-protected:
+private:
     T _value;
 };
 
+/**
+ * A document template lowered to a flat list of instructions that write BSON, along with the
+ * constants and generators they refer to.
+ *
+ * Everything that doesn't depend on a generator is encoded while building the program: runs
+ * of constant elements, whole constant sub-documents and arrays, and the type and key of
+ * generated elements become a single kSplice of pre-encoded bytes. Only the lengths of
+ * documents and arrays that contain generated values are filled in while running.
+ *
+ * Instructions are in the same depth-first order as the template so random values are drawn
+ * in the same order as they would be by walking the template.
+ */
+class Program {
+public:
+    enum class Op : uint8_t {
+        // Copy pre-encoded bytes out of the constant pool.
+        kSplice,
+        // Note where a document or array starts. Its length placeholder was `arg` bytes ago.
+        kOpen,
+        // Write the next value from a generator.
+        kInt64,
+        kString,
+        kValue,
+        // Terminate the innermost document or array and fill in its length.
+        kEnd,
+    };
+
+    struct Instruction {
+        Op op;
+        // kSplice: where the bytes are in _constants. kOpen: see above. kInt64, kString and
+        // kValue: which generator to use.
+        uint32_t arg;
+        // kSplice: how many bytes.
+        uint32_t size;
+    };
+
+    /**
+     * Starts the top-level document.
+     * @param actorId the Actor the documents are for, used by generators that partition
+     * values between Actors.
+     * @param incCounter shared by the Actor's `^Inc`s, or nullptr for the program's own.
+     */
+    Program(genny::ActorId actorId, std::atomic<uint64_t>* incCounter)
+        : _actorId{actorId}, _incCounter{incCounter} {
+        if (!_incCounter) {
+            _ownIncCounter = std::make_unique<std::atomic<uint64_t>>(0);
+            _incCounter = _ownIncCounter.get();
+        }
+        open();
+    }
+
+    genny::ActorId actorId() const {
+        return _actorId;
+    }
+
+    std::atomic<uint64_t>& incCounter() const {
+        return *_incCounter;
+    }
+
+    void constant(std::string_view key, bsoncxx::type type, std::string_view encoded) {
+        element(key, type);
+        _pending.append(encoded);
+    }
+
+    void int64(std::string_view key, UniqueGenerator<int64_t> generator) {
+        element(key, bsoncxx::type::k_int64);
+        flush();
+        _code.push_back({Op::kInt64, uint32_t(_int64s.size()), 0});
+        _int64s.push_back(std::move(generator));
+    }
+
+    void string(std::string_view key, std::unique_ptr<StringAppender> generator) {
+        element(key, bsoncxx::type::k_utf8);
+        flush();
+        _code.push_back({Op::kString, uint32_t(_strings.size()), 0});
+        _strings.push_back(std::move(generator));
+    }
+
+    void value(std::string_view key, bsoncxx::type type, std::unique_ptr<ValueAppender> generator) {
+        element(key, type);
+        flush();
+        _code.push_back({Op::kValue, uint32_t(_values.size()), 0});
+        _values.push_back(std::move(generator));
+    }
+
+    void beginDocument(std::string_view key) {
+        element(key, bsoncxx::type::k_document);
+        open();
+    }
+
+    void beginArray(std::string_view key) {
+        element(key, bsoncxx::type::k_array);
+        open();
+    }
+
+    void end() {
+        const auto container = _building.back();
+        _building.pop_back();
+        if (container.spliced) {
+            flush();
+            _code.push_back({Op::kEnd, 0, 0});
+            return;
+        }
+        // Nothing generated since it was opened so it's still all in _pending.
+        _pending.push_back('\0');
+        const auto size = int32_t(_pending.size() - container.placeholder);
+        std::memcpy(&_pending[container.placeholder], &size, sizeof(size));
+    }
+
+    /**
+     * Ends the top-level document. Nothing can be added after this.
+     */
+    void finish() {
+        end();
+        flush();
+    }
+
+    /**
+     * Write a document to the end of `out`.
+     */
+    void run(std::string& out) {
+        _starts.clear();
+        _starts.reserve(_depth);
+
+        for (const auto& instruction : _code) {
+            switch (instruction.op) {
+                case Op::kSplice:
+                    out.append(_constants, instruction.arg, instruction.size);
+                    break;
+                case Op::kOpen:
+                    _starts.push_back(out.size() - instruction.arg);
+                    break;
+                case Op::kInt64:
+                    appendRaw(out, _int64s[instruction.arg]->evaluate());
+                    break;
+                case Op::kString: {
+                    const auto start = out.size();
+                    appendRaw(out, int32_t{0});
+                    _strings[instruction.arg]->appendTo(out);
+                    out.push_back('\0');
+                    const auto size = int32_t(out.size() - start - sizeof(int32_t));
+                    std::memcpy(&out[start], &size, sizeof(size));
+                    break;
+                }
+                case Op::kValue:
+                    _values[instruction.arg]->appendTo(out);
+                    break;
+                case Op::kEnd: {
+                    out.push_back('\0');
+                    const auto start = _starts.back();
+                    _starts.pop_back();
+                    const auto size = int32_t(out.size() - start);
+                    std::memcpy(&out[start], &size, sizeof(size));
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    struct Container {
+        // Where the length goes in _pending.
+        size_t placeholder;
+        // Whether the placeholder was already spliced and so has to be filled in by kEnd.
+        bool spliced;
+    };
+
+    void element(std::string_view key, bsoncxx::type type) {
+        _pending.push_back(static_cast<char>(type));
+        _pending.append(key);
+        _pending.push_back('\0');
+    }
+
+    void open() {
+        _building.push_back({_pending.size(), false});
+        _depth = std::max(_depth, _building.size());
+        appendRaw(_pending, int32_t{0});
+    }
+
+    // Splice what's pending before something that has to happen while running.
+    void flush() {
+        if (_pending.empty()) {
+            return;
+        }
+        _code.push_back({Op::kSplice, uint32_t(_constants.size()), uint32_t(_pending.size())});
+        // Containers not spliced yet were opened since the last flush, outermost first.
+        for (auto& container : _building) {
+            if (!container.spliced) {
+                container.spliced = true;
+                _code.push_back({Op::kOpen, uint32_t(_pending.size() - container.placeholder), 0});
+            }
+        }
+        _constants.append(_pending);
+        _pending.clear();
+    }
+
+    std::vector<Instruction> _code;
+    std::string _constants;
+    std::vector<UniqueGenerator<int64_t>> _int64s;
+    std::vector<std::unique_ptr<StringAppender>> _strings;
+    std::vector<std::unique_ptr<ValueAppender>> _values;
+    genny::ActorId _actorId;
+    std::atomic<uint64_t>* _incCounter;
+    // Heap-allocated so _incCounter stays valid when the program is moved.
+    std::unique_ptr<std::atomic<uint64_t>> _ownIncCounter;
+
+    // Encoded but not yet spliced.
+    std::string _pending;
+    // Documents and arrays opened but not ended while building the program.
+    std::vector<Container> _building;
+    size_t _depth = 0;
+
+    // Where the length of each document or array being written goes.
+    std::vector<size_t> _starts;
+};
+
+template <typename T>
+std::string encode(T value) {
+    std::string out;
+    appendRaw(out, value);
+    return out;
+}
+
+std::string encodeString(const std::string& str) {
+    std::string out;
+    appendRaw(out, int32_t(str.size() + 1));
+    out.append(str.c_str(), str.size() + 1);
+    return out;
+}
+
 }  // namespace
 
 
 namespace genny {
 
-class DocumentGenerator::Impl : public Generator<bsoncxx::document::value> {
+class DocumentGenerator::Impl {
 public:
-    using Entries = std::vector<std::pair<std::string, UniqueAppendable>>;
-
-    explicit Impl(Entries entries) : _entries{std::move(entries)} {}
+    explicit Impl(Program program) : _program{std::move(program)} {}
+
+    bsoncxx::document::value evaluate() {
+        _buffer.clear();
+        _program.run(_buffer);
+        auto data = new uint8_t[_buffer.size()];
+        std::memcpy(data, _buffer.data(), _buffer.size());
+        return bsoncxx::document::value{data, _buffer.size(), [](uint8_t* ptr) { delete[] ptr; }};
+    }
 
-    bsoncxx::document::value evaluate() override {
-        bsoncxx::builder::basic::document builder;
-        for (auto&& [k, app] : _entries) {
-            app->append(k, builder);
-        }
-        return builder.extract();
+    void run(std::string& out) {
+        _program.run(out);
     }
 
 private:
-    Entries _entries;
+    Program _program;
+    // Kept between documents so it only grows to the size of the biggest document once.
+    std::string _buffer;
 };
 
 namespace {
@@ -147,6 +403,9 @@ static const std::string kDefaultAlphabet = std::string{
 template <typename O>
 using Parser = std::function<O(const Node&, DefaultRandom&)>;
 
+// Adds the instructions for a `^`-prefixed value with the given key to the program.
+using Emitter = std::function<void(Program&, std::string_view, const Node&, DefaultRandom&)>;
+
 // Pre-declaring all at once
 // Documentation is at the implementations-site.
 
@@ -154,10 +413,10 @@ UniqueGenerator<int64_t> intGenerator(const Node& node, DefaultRandom& rng);
 UniqueGenerator<int64_t> int64GeneratorBasedOnDistribution(const Node& node, DefaultRandom& rng);
 
 template <bool Verbatim>
-std::unique_ptr<DocumentGenerator::Impl> documentGenerator(const Node& node, DefaultRandom& rng);
+void documentGenerator(Program& program, const Node& node, DefaultRandom& rng);
 
 template <bool Verbatim>
-UniqueGenerator<bsoncxx::array::value> arrayGenerator(const Node& node, DefaultRandom& rng);
+void arrayGenerator(Program& program, const Node& node, DefaultRandom& rng);
 
 /** `{^RandomInt:{distribution:uniform ...}}` */
 class UniformInt64Generator : public Generator<int64_t> {
@@ -256,8 +515,319 @@ private:
     const double _p;
 };
 
+/**
+ * A fixed shuffle of `[0, n)` so the most likely values of a skewed distribution aren't next
+ * to each other. Every generator with the same `n` uses the same shuffle, so all Actors agree
+ * on which keys are hot.
+ */
+class Scrambler {
+public:
+    /** @param n the number of values, or 0 for all 2^64 of them. */
+    explicit Scrambler(uint64_t n) : _n{n} {
+        _bits = n == 0 ? 64 : 0;
+        while (_bits < 64 && (uint64_t{1} << _bits) < n) {
+            ++_bits;
+        }
+        _mask = _bits == 64 ? ~uint64_t{0} : (uint64_t{1} << _bits) - 1;
+    }
+
+    uint64_t operator()(uint64_t x) const {
+        if (_n == 0) {
+            return mix(x);
+        }
+        // Each step is a bijection of [0, 2^_bits), and 2^_bits < 2n, so walking the cycle
+        // until it lands back in [0, n) takes fewer than two steps on average.
+        do {
+            x = mix(x);
+        } while (x >= _n);
+        return x;
+    }
+
+private:
+    uint64_t mix(uint64_t x) const {
+        const int shift = std::max(_bits / 2, 1);
+        x = (x * 0x9e3779b97f4a7c15ull + 0x632be59bd9b4e019ull) & _mask;
+        x ^= x >> shift;
+        x = (x * 0xbf58476d1ce4e5b9ull) & _mask;
+        x ^= x >> shift;
+        return x;
+    }
+
+    uint64_t _n;
+    int _bits;
+    uint64_t _mask;
+};
+
+// The largest double below 2^64, so converting it to uint64_t is defined.
+constexpr double kMaxCount = 18446744073709549568.0;
+
+/**
+ * Shared by the skewed distributions: `{min:<int>, max:<int>, scramble:opt bool}`.
+ * Unlike uniform, `min` and `max` have to be constants so the set-up can be done once.
+ */
+class SkewedInt64Generator : public Generator<int64_t> {
+public:
+    SkewedInt64Generator(const Node& node, DefaultRandom& rng, const std::string& name)
+        : _rng{rng},
+          _min{extract(node, "min", name).to<int64_t>()},
+          _max{extract(node, "max", name).to<int64_t>()},
+          _scramble{node["scramble"].maybe<bool>().value_or(true)},
+          _scrambler{count()} {
+        if (_max < _min) {
+            BOOST_THROW_EXCEPTION(
+                InvalidValueGeneratorSyntax(name + " requires min to be at most max"));
+        }
+    }
+
+    int64_t evaluate() override {
+        auto rank = sample();
+        if (_scramble) {
+            rank = _scrambler(rank);
+        }
+        return int64_t(uint64_t(_min) + rank);
+    }
+
+protected:
+    /**
+     * @return a value in `[0, count())`. 0 is the most likely.
+     */
+    virtual uint64_t sample() = 0;
 
-class StringGenerator : public Generator<std::string> {
+    /**
+     * @return how many values there are. Only 0 if min and max span every int64.
+     */
+    uint64_t count() const {
+        return uint64_t(_max) - uint64_t(_min) + 1;
+    }
+
+    /**
+     * @return count() as a double, which is never rounded up to more than can be returned.
+     */
+    double countAsDouble() const {
+        return count() == 0 ? kMaxCount : std::min(double(count()), kMaxCount);
+    }
+
+    DefaultRandom& _rng;
+    boost::random::uniform_01<double> _uniform;
+
+private:
+    const int64_t _min;
+    const int64_t _max;
+    const bool _scramble;
+    const Scrambler _scrambler;
+};
+
+/**
+ * `{^RandomInt:{distribution:zipfian...}}`
+ *
+ * Value `min + k` has probability proportional to `1/(k+1)^s`. Uses Hörmann and Derflinger's
+ * rejection-inversion sampling so each value takes a constant expected time and no memory
+ * however far apart min and max are.
+ */
+class ZipfianInt64Generator : public SkewedInt64Generator {
+public:
+    /** @param node `{min:<int>, max:<int>, s:opt double (default 0.99), scramble:opt bool}` */
+    ZipfianInt64Generator(const Node& node, DefaultRandom& rng)
+        : SkewedInt64Generator{node, rng, "zipfian"},
+          _exponent{node["s"].maybe<double>().value_or(0.99)},
+          _n{countAsDouble()} {
+        if (!(_exponent > 0)) {
+            BOOST_THROW_EXCEPTION(InvalidValueGeneratorSyntax("zipfian requires s > 0"));
+        }
+        _hIntegralX1 = hIntegral(1.5) - 1;
+        _hIntegralN = hIntegral(_n + 0.5);
+        _threshold = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+    }
+
+protected:
+    uint64_t sample() override {
+        // Ranks here are 1-based as in the paper.
+        while (true) {
+            const auto u = _hIntegralN + _uniform(_rng) * (_hIntegralX1 - _hIntegralN);
+            const auto x = hIntegralInverse(u);
+            auto k = std::clamp(x + 0.5, 1.0, _n);
+            k = std::floor(k);
+            if (k - x <= _threshold || u >= hIntegral(k + 0.5) - h(k)) {
+                // double(count()) may have been rounded up.
+                return std::min(uint64_t(k) - 1, count() - 1);
+            }
+        }
+    }
+
+private:
+    double h(double x) const {
+        return std::exp(-_exponent * std::log(x));
+    }
+
+    double hIntegral(double x) const {
+        const auto logX = std::log(x);
+        return helper2((1 - _exponent) * logX) * logX;
+    }
+
+    double hIntegralInverse(double x) const {
+        auto t = x * (1 - _exponent);
+        if (t < -1) {
+            // Only from rounding errors.
+            t = -1;
+        }
+        return std::exp(helper1(t) * x);
+    }
+
+    // log(1+x)/x, accurate near 0.
+    static double helper1(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+
+    // (exp(x)-1)/x, accurate near 0.
+    static double helper2(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x
+                                  : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+    }
+
+    const double _exponent;
+    const double _n;
+    double _hIntegralX1;
+    double _hIntegralN;
+    double _threshold;
+};
+
+/**
+ * `{^RandomInt:{distribution:hotspot...}}`
+ *
+ * `hotOpFraction` of the values come from the first `hotFraction` of `[min, max]` (before
+ * scrambling) and the rest from the remainder, both uniformly.
+ */
+class HotspotInt64Generator : public SkewedInt64Generator {
+public:
+    /**
+     * @param node `{min:<int>, max:<int>, hotFraction:double, hotOpFraction:double,
+     *               scramble:opt bool}`
+     */
+    HotspotInt64Generator(const Node& node, DefaultRandom& rng)
+        : SkewedInt64Generator{node, rng, "hotspot"},
+          _hotOpFraction{extract(node, "hotOpFraction", "hotspot").to<double>()} {
+        const auto hotFraction = extract(node, "hotFraction", "hotspot").to<double>();
+        if (!(hotFraction > 0 && hotFraction <= 1) ||
+            !(_hotOpFraction >= 0 && _hotOpFraction <= 1)) {
+            BOOST_THROW_EXCEPTION(InvalidValueGeneratorSyntax(
+                "hotspot requires 0 < hotFraction <= 1 and 0 <= hotOpFraction <= 1"));
+        }
+        const auto last = count() - 1;
+        const auto hot = countAsDouble() * hotFraction;
+        if (hot >= countAsDouble()) {
+            // Everything's hot.
+            _hot = boost::random::uniform_int_distribution<uint64_t>{0, last};
+            _hotOpFraction = 1;
+            return;
+        }
+        const auto lastHot = std::max<uint64_t>(1, uint64_t(hot)) - 1;
+        _hot = boost::random::uniform_int_distribution<uint64_t>{0, lastHot};
+        _cold = boost::random::uniform_int_distribution<uint64_t>{lastHot + 1, last};
+    }
+
+protected:
+    uint64_t sample() override {
+        if (_hotOpFraction == 1 || _uniform(_rng) < _hotOpFraction) {
+            return _hot(_rng);
+        }
+        return _cold(_rng);
+    }
+
+private:
+    double _hotOpFraction;
+    boost::random::uniform_int_distribution<uint64_t> _hot;
+    boost::random::uniform_int_distribution<uint64_t> _cold;
+};
+
+/**
+ * `{^Inc:{...}}`
+ *
+ * Counts up from a start that depends on the ActorId so each Actor's values are unique
+ * without the Actors having to share a counter. Every `^Inc` for one Actor counts with the
+ * same counter, so two templates used by the same Actor don't give the same values.
+ */
+class IncGenerator : public Generator<int64_t> {
+public:
+    /**
+     * @param node `{start:opt int (default 0), multiplier:opt int (default 2^32),
+     *               step:opt int (default 1)}`. The first value is `start + multiplier * id`.
+     * @param counter how many values the Actor's `^Inc`s have given so far.
+     */
+    IncGenerator(const Node& node, ActorId id, std::atomic<uint64_t>& counter)
+        : _step{node["step"].maybe<int64_t>().value_or(1)}, _counter{&counter} {
+        const auto start = node["start"].maybe<int64_t>().value_or(0);
+        const auto multiplier = node["multiplier"].maybe<int64_t>().value_or(int64_t{1} << 32);
+        // Unsigned so that overflowing wraps around rather than being undefined.
+        _first = uint64_t(start) + uint64_t(multiplier) * id;
+    }
+
+    int64_t evaluate() override {
+        // Only the Actor's thread and its DocumentPipeline thread count with it, and only
+        // uniqueness matters, so relaxed is enough.
+        const auto n = _counter->fetch_add(1, std::memory_order_relaxed);
+        return int64_t(_first + uint64_t(_step) * n);
+    }
+
+private:
+    const int64_t _step;
+    std::atomic<uint64_t>* _counter;
+    uint64_t _first;
+};
+
+/**
+ * `{^ObjectId:{}}`
+ *
+ * ObjectIds made the same way as the driver and server make them: a big-endian timestamp in
+ * seconds, 5 bytes unique to the generator, and a big-endian counter. Each generator has its
+ * own counter so no state is shared between threads.
+ */
+class ObjectIdGenerator : public ValueAppender {
+public:
+    explicit ObjectIdGenerator(DefaultRandom& rng)
+        : _start{uint32_t(rng()) & kCounterMask}, _counter{_start} {
+        // Random between processes and then different for each generator in the process.
+        static const uint64_t processUnique = [] {
+            std::random_device device;
+            return (uint64_t(device()) << 32) | device();
+        }();
+        static std::atomic<uint64_t> generators{0};
+        const auto unique = processUnique + generators.fetch_add(1);
+        for (size_t i = 0; i < sizeof(_unique); ++i) {
+            _unique[i] = char(unique >> (8 * (sizeof(_unique) - 1 - i)));
+        }
+    }
+
+    void appendTo(std::string& out) override {
+        // Never go back in time, so every id in one pass of the counter is after the last.
+        _seconds = std::max(_seconds, uint32_t(std::time(nullptr)));
+
+        char oid[12];
+        const auto seconds = __builtin_bswap32(_seconds);
+        std::memcpy(oid, &seconds, sizeof(seconds));
+        std::memcpy(oid + 4, _unique, sizeof(_unique));
+        oid[9] = char(_counter >> 16);
+        oid[10] = char(_counter >> 8);
+        oid[11] = char(_counter);
+        out.append(oid, sizeof(oid));
+
+        _counter = (_counter + 1) & kCounterMask;
+        if (_counter == _start) {
+            // The counter has gone all the way around, so later ids need a later timestamp.
+            ++_seconds;
+        }
+    }
+
+private:
+    static constexpr uint32_t kCounterMask = (uint32_t{1} << 24) - 1;
+
+    char _unique[5];
+    const uint32_t _start;
+    uint32_t _counter;
+    uint32_t _seconds = 0;
+};
+
+
+class StringGenerator : public StringAppender {
 public:
     StringGenerator(const Node& node, DefaultRandom& rng)
         : _rng{rng},
@@ -286,83 +856,313 @@ public:
     NormalRandomStringGenerator(const Node& node, DefaultRandom& rng)
         : StringGenerator(node, rng) {}
 
-    std::string evaluate() override {
+    void appendTo(std::string& out) override {
         auto distribution = boost::random::uniform_int_distribution<size_t>{0, _alphabetLength - 1};
 
-        auto length = _lengthGen->evaluate();
-        std::string str(length, '\0');
+        // Like ^FastRandomString, a negative length gives an empty string.
+        const auto length = std::max<int64_t>(_lengthGen->evaluate(), 0);
+        const auto start = out.size();
+        out.resize(start + length);
+        auto str = &out[start];
 
-        for (int i = 0; i < length; ++i) {
+        for (int64_t i = 0; i < length; ++i) {
             str[i] = _alphabet[distribution(_rng)];
         }
+    }
+};
+
+/**
+ * Random bytes for ^FastRandomString. splitmix64 is much cheaper per byte than DefaultRandom
+ * and only needs one value from it to seed each string.
+ */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : _state{seed} {}
 
-        return str;
+    uint64_t operator()() {
+        auto z = (_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
     }
+
+private:
+    uint64_t _state;
 };
 
+/**
+ * Replace each byte of `str` with `table[byte % 64]`. The vectorized versions give exactly
+ * the same output so documents don't depend on which CPU generated them.
+ */
+using MapToAlphabet = void (*)(char* str, size_t length, const char* table);
+
+void mapToAlphabetScalar(char* str, size_t length, const char* table) {
+    for (size_t i = 0; i < length; ++i) {
+        str[i] = table[static_cast<uint8_t>(str[i]) & 0x3f];
+    }
+}
+
+#if defined(__x86_64__)
+
+// The table is 64 bytes but a shuffle only looks up 16, so look each byte up in all four
+// quarters and pick the right one using bits 4 and 5 of the index.
+
+__attribute__((target("sse4.1"))) void mapToAlphabetSse(char* str,
+                                                         size_t length,
+                                                         const char* table) {
+    const auto quarters = reinterpret_cast<const __m128i*>(table);
+    const __m128i t0 = _mm_loadu_si128(quarters), t1 = _mm_loadu_si128(quarters + 1),
+                  t2 = _mm_loadu_si128(quarters + 2), t3 = _mm_loadu_si128(quarters + 3);
+    const __m128i mask = _mm_set1_epi8(0x3f);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto ptr = reinterpret_cast<__m128i*>(str + i);
+        // Masking also clears bit 7, which would make the shuffle give 0.
+        const __m128i idx = _mm_and_si128(_mm_loadu_si128(ptr), mask);
+        // blendv picks by bit 7 of each byte, so shift bit 4 and bit 5 up to it.
+        const __m128i bit4 = _mm_slli_epi16(idx, 3);
+        const __m128i bit5 = _mm_slli_epi16(idx, 2);
+        const __m128i low = _mm_blendv_epi8(
+            _mm_shuffle_epi8(t0, idx), _mm_shuffle_epi8(t1, idx), bit4);
+        const __m128i high = _mm_blendv_epi8(
+            _mm_shuffle_epi8(t2, idx), _mm_shuffle_epi8(t3, idx), bit4);
+        _mm_storeu_si128(ptr, _mm_blendv_epi8(low, high, bit5));
+    }
+    mapToAlphabetScalar(str + i, length - i, table);
+}
+
+__attribute__((target("avx2"))) void mapToAlphabetAvx2(char* str,
+                                                       size_t length,
+                                                       const char* table) {
+    // vpshufb looks up within each 128-bit lane so both lanes get the same quarter.
+    const auto quarters = reinterpret_cast<const __m128i*>(table);
+    const __m256i t0 = _mm256_broadcastsi128_si256(_mm_loadu_si128(quarters)),
+                  t1 = _mm256_broadcastsi128_si256(_mm_loadu_si128(quarters + 1)),
+                  t2 = _mm256_broadcastsi128_si256(_mm_loadu_si128(quarters + 2)),
+                  t3 = _mm256_broadcastsi128_si256(_mm_loadu_si128(quarters + 3));
+    const __m256i mask = _mm256_set1_epi8(0x3f);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        auto ptr = reinterpret_cast<__m256i*>(str + i);
+        const __m256i idx = _mm256_and_si256(_mm256_loadu_si256(ptr), mask);
+        const __m256i bit4 = _mm256_slli_epi16(idx, 3);
+        const __m256i bit5 = _mm256_slli_epi16(idx, 2);
+        const __m256i low = _mm256_blendv_epi8(
+            _mm256_shuffle_epi8(t0, idx), _mm256_shuffle_epi8(t1, idx), bit4);
+        const __m256i high = _mm256_blendv_epi8(
+            _mm256_shuffle_epi8(t2, idx), _mm256_shuffle_epi8(t3, idx), bit4);
+        _mm256_storeu_si256(ptr, _mm256_blendv_epi8(low, high, bit5));
+    }
+    mapToAlphabetScalar(str + i, length - i, table);
+}
+
+MapToAlphabet pickMapToAlphabet() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return mapToAlphabetAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return mapToAlphabetSse;
+    }
+    return mapToAlphabetScalar;
+}
+
+#else
+
+MapToAlphabet pickMapToAlphabet() {
+    return mapToAlphabetScalar;
+}
+
+#endif  // defined(__x86_64__)
+
+const MapToAlphabet mapToAlphabet = pickMapToAlphabet();
+
 /** `{^FastRandomString:{...}` */
 class FastRandomStringGenerator : public StringGenerator {
 public:
-    /** @param node `{length:<int>, alphabet:opt str}` */
-    FastRandomStringGenerator(const Node& node, DefaultRandom& rng) : StringGenerator(node, rng) {}
+    /**
+     * @param node `{length:<int>, alphabet:opt str}`. Only the first 64 characters of the
+     * alphabet are used.
+     */
+    FastRandomStringGenerator(const Node& node, DefaultRandom& rng) : StringGenerator(node, rng) {
+        for (size_t i = 0; i < sizeof(_table); ++i) {
+            _table[i] = _alphabet[i % _alphabetLength];
+        }
+    }
 
-    std::string evaluate() override {
+    void appendTo(std::string& out) override {
         auto length = _lengthGen->evaluate();
-        std::string str(length, '\0');
-
-        auto randomValue = _rng();
-        int bits = 64;
+        // Always take one value, even for empty strings, so the values drawn for the rest of
+        // the document don't depend on the length.
+        SplitMix64 bytes{_rng()};
+        if (length <= 0) {
+            return;
+        }
 
-        for (int i = 0; i < length; ++i) {
-            if (bits < 6) {
-                randomValue = _rng();
-                bits = 64;
-            }
+        const auto start = out.size();
+        out.resize(start + length);
+        auto str = &out[start];
 
-            str[i] = _alphabet[(randomValue & 0x2f) % _alphabetLength];
-            randomValue >>= 6;
-            bits -= 6;
+        for (int64_t i = 0; i < length; i += sizeof(uint64_t)) {
+            const auto value = bytes();
+            std::memcpy(str + i, &value, std::min<int64_t>(sizeof(value), length - i));
         }
-        return str;
+        mapToAlphabet(str, length, _table);
     }
+
+private:
+    // The alphabet repeated to 64 characters so every 6-bit value picks one.
+    char _table[64];
 };
 
-/** `{a: [...]}` */
-class ArrayGenerator : public Generator<bsoncxx::array::value> {
+/**
+ * Random bytes made once and shared by every thread, so that big values can be copied out of
+ * it instead of being generated byte by byte.
+ */
+class Slab {
 public:
-    using ValueType = std::vector<UniqueAppendable>;
+    // A power of two so offsets can be masked.
+    static constexpr size_t kSize = size_t{16} << 20;
+
+    /**
+     * @return the slab for binary values.
+     */
+    static const Slab& bytes() {
+        static const Slab slab{false};
+        return slab;
+    }
 
-    explicit ArrayGenerator(ValueType values) : _values{std::move(values)} {}
+    /**
+     * @return the slab for strings. It only has characters from the default alphabet.
+     */
+    static const Slab& alphabet() {
+        static const Slab slab{true};
+        return slab;
+    }
+
+    /**
+     * Append `length` bytes starting at `offset`, going back to the start of the slab when
+     * the end is reached.
+     */
+    void appendTo(std::string& out, size_t offset, size_t length) const {
+        offset &= kSize - 1;
+        while (length > 0) {
+            const auto size = std::min(length, kSize - offset);
+            out.append(_bytes, offset, size);
+            length -= size;
+            offset = 0;
+        }
+    }
 
-    bsoncxx::array::value evaluate() override {
-        bsoncxx::builder::basic::array builder{};
-        for (auto&& value : _values) {
-            value->append(builder);
+private:
+    explicit Slab(bool alphabet) : _bytes(kSize, '\0') {
+        // A fixed seed so values are the same between runs, like everything else generated.
+        SplitMix64 bytes{kSize};
+        for (size_t i = 0; i < kSize; i += sizeof(uint64_t)) {
+            const auto value = bytes();
+            std::memcpy(&_bytes[i], &value, sizeof(value));
         }
-        return builder.extract();
+        if (alphabet) {
+            char table[64];
+            for (size_t i = 0; i < sizeof(table); ++i) {
+                table[i] = kDefaultAlphabet[i % kDefaultAlphabet.size()];
+            }
+            mapToAlphabet(&_bytes[0], kSize, table);
+        }
+    }
+
+    std::string _bytes;
+};
+
+/**
+ * Picks where in a Slab each value starts.
+ */
+class SlabSlicer {
+public:
+    /** @param node `{length:<int>}` */
+    SlabSlicer(const Node& node, DefaultRandom& rng, const Slab& slab, const std::string& name)
+        : _rng{rng}, _lengthGen{intGenerator(extract(node, "length", name), rng)}, _slab{slab} {}
+
+    /**
+     * @return the length of the next value, which `appendTo()` must be called with.
+     */
+    size_t length() {
+        return size_t(std::max<int64_t>(_lengthGen->evaluate(), 0));
+    }
+
+    void appendTo(std::string& out, size_t length) {
+        // Like ^FastRandomString, take a value even when the length is 0.
+        _slab.appendTo(out, _rng(), length);
+    }
+
+private:
+    DefaultRandom& _rng;
+    UniqueGenerator<int64_t> _lengthGen;
+    const Slab& _slab;
+};
+
+/**
+ * `{^RandomBinary:{...}}`
+ *
+ * Generic binary data copied from a random place in a shared Slab. Values longer than the slab
+ * repeat it.
+ */
+class RandomBinaryGenerator : public ValueAppender {
+public:
+    /** @param node `{length:<int>}` */
+    RandomBinaryGenerator(const Node& node, DefaultRandom& rng)
+        : _slicer{node, rng, Slab::bytes(), "^RandomBinary"} {}
+
+    void appendTo(std::string& out) override {
+        const auto length = _slicer.length();
+        appendRaw(out, int32_t(length));
+        out.push_back(static_cast<char>(bsoncxx::binary_sub_type::k_binary));
+        _slicer.appendTo(out, length);
+    }
+
+private:
+    SlabSlicer _slicer;
+};
+
+/**
+ * `{^RandomSlabString:{...}}`
+ *
+ * Like `^FastRandomString` with the default alphabet but copied from a shared Slab, for
+ * strings so big that filling them dominates generating the document.
+ */
+class SlabStringGenerator : public StringAppender {
+public:
+    /** @param node `{length:<int>}` */
+    SlabStringGenerator(const Node& node, DefaultRandom& rng)
+        : _slicer{node, rng, Slab::alphabet(), "^RandomSlabString"} {}
+
+    void appendTo(std::string& out) override {
+        _slicer.appendTo(out, _slicer.length());
     }
 
 private:
-    const ValueType _values;
+    SlabSlicer _slicer;
 };
 
 /**
- * @tparam O
- *   parser output type
+ * @tparam P
+ *   parser type, e.g. Parser<O> or Emitter
  * @param node
  *   a sub-field e.g. {^RandomInt:{...}} or a scalar.
  * @param parsers
- *   Which parsers (all of type Parser<O>) to use.
- * @return Parser<O>
+ *   Which parsers (all of type P) to use.
+ * @return P
  *   if the document reprents a evaluate-able structure.
  *   E.g. returns the randomInt parser if node is {^RandomInt:{...}}
  *   or nullopt if node is a scalar etc. Throws if node looks
  *   evaluate-able but e.g. has two ^-prefixed keys or if the ^-prefixed
  *   key isn't in the list of parsers.
  */
-template <typename O>
-std::optional<std::pair<Parser<O>, std::string>> extractKnownParser(
-    const Node& node, DefaultRandom& rng, std::map<std::string, Parser<O>> parsers) {
+template <typename P>
+std::optional<std::pair<P, std::string>> extractKnownParser(
+    const Node& node, DefaultRandom& rng, const std::map<std::string, P>& parsers) {
     if (!node || !node.isMap()) {
         return std::nullopt;
     }
@@ -373,7 +1173,7 @@ std::optional<std::pair<Parser<O>, std::string>> extractKnownParser(
     }
 
     if (auto parser = parsers.find(*metaKey); parser != parsers.end()) {
-        return std::make_optional<std::pair<Parser<O>, std::string>>({parser->second, *metaKey});
+        return std::make_optional<std::pair<P, std::string>>({parser->second, *metaKey});
     }
 
     std::stringstream msg;
@@ -385,52 +1185,65 @@ std::optional<std::pair<Parser<O>, std::string>> extractKnownParser(
  * Main entry-point into depth-first construction.
  *
  * @tparam Verbatim if we're in a ^Verbatim node
- * @tparam Out desired Parser output type
+ * @param key the key of the value in its document or array
  * @param node any type of node e.g. {a:1}, {^RandomInt:{...}}, [{a:1},{^RandomInt}]
- * @param parsers must all be of type Parser<O>
- * @return the indicated parser
  */
-template <bool Verbatim, typename Out>
-Out valueGenerator(const Node& node,
-                   DefaultRandom& rng,
-                   const std::map<std::string, Parser<Out>>& parsers) {
+template <bool Verbatim>
+void valueGenerator(Program& program,
+                    std::string_view key,
+                    const Node& node,
+                    DefaultRandom& rng,
+                    const std::map<std::string, Emitter>& emitters) {
     if constexpr (!Verbatim) {
-        if (auto parserPair = extractKnownParser(node, rng, parsers)) {
+        if (auto emitterPair = extractKnownParser(node, rng, emitters)) {
             // known parser type
-            return parserPair->first(node[parserPair->second], rng);
+            emitterPair->first(program, key, node[emitterPair->second], rng);
+            return;
         }
     }
     // switch-statement on node.Type() may be clearer
 
     if (node.isNull()) {
-        return std::make_unique<ConstantAppender<bsoncxx::types::b_null>>();
+        program.constant(key, bsoncxx::type::k_null, {});
+        return;
     }
     if (node.isScalar()) {
         if (node.tag() != "!") {
             try {
-                return std::make_unique<ConstantAppender<int32_t>>(node.to<int32_t>());
+                program.constant(key, bsoncxx::type::k_int32, encode(node.to<int32_t>()));
+                return;
             } catch (const InvalidConversionException& e) {
             }
             try {
-                return std::make_unique<ConstantAppender<int64_t>>(node.to<int64_t>());
+                program.constant(key, bsoncxx::type::k_int64, encode(node.to<int64_t>()));
+                return;
             } catch (const InvalidConversionException& e) {
             }
             try {
-                return std::make_unique<ConstantAppender<double>>(node.to<double>());
+                program.constant(key, bsoncxx::type::k_double, encode(node.to<double>()));
+                return;
             } catch (const InvalidConversionException& e) {
             }
             try {
-                return std::make_unique<ConstantAppender<bool>>(node.to<bool>());
+                program.constant(key, bsoncxx::type::k_bool, encode(node.to<bool>()));
+                return;
             } catch (const InvalidConversionException& e) {
             }
         }
-        return std::make_unique<ConstantAppender<std::string>>(node.to<std::string>());
+        program.constant(key, bsoncxx::type::k_utf8, encodeString(node.to<std::string>()));
+        return;
     }
     if (node.isSequence()) {
-        return arrayGenerator<Verbatim>(node, rng);
+        program.beginArray(key);
+        arrayGenerator<Verbatim>(program, node, rng);
+        program.end();
+        return;
     }
     if (node.isMap()) {
-        return documentGenerator<Verbatim>(node, rng);
+        program.beginDocument(key);
+        documentGenerator<Verbatim>(program, node, rng);
+        program.end();
+        return;
     }
 
     std::stringstream msg;
@@ -438,30 +1251,53 @@ Out valueGenerator(const Node& node,
     BOOST_THROW_EXCEPTION(InvalidValueGeneratorSyntax(msg.str()));
 }
 
-const static std::map<std::string, Parser<UniqueAppendable>> allParsers{
+const static std::map<std::string, Emitter> allParsers{
     {"^FastRandomString",
-     [](const Node& node, DefaultRandom& rng) {
-         return std::make_unique<FastRandomStringGenerator>(node, rng);
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.string(key, std::make_unique<FastRandomStringGenerator>(node, rng));
      }},
     {"^RandomString",
-     [](const Node& node, DefaultRandom& rng) {
-         return std::make_unique<NormalRandomStringGenerator>(node, rng);
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.string(key, std::make_unique<NormalRandomStringGenerator>(node, rng));
+     }},
+    {"^Inc",
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.int64(
+             key,
+             std::make_unique<IncGenerator>(node, program.actorId(), program.incCounter()));
+     }},
+    {"^ObjectId",
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.value(key, bsoncxx::type::k_oid, std::make_unique<ObjectIdGenerator>(rng));
+     }},
+    {"^RandomBinary",
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.value(
+             key, bsoncxx::type::k_binary, std::make_unique<RandomBinaryGenerator>(node, rng));
+     }},
+    {"^RandomInt",
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.int64(key, int64GeneratorBasedOnDistribution(node, rng));
+     }},
+    {"^RandomSlabString",
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         program.string(key, std::make_unique<SlabStringGenerator>(node, rng));
      }},
-    {"^RandomInt", int64GeneratorBasedOnDistribution},
     {"^Verbatim",
-     [](const Node& node, DefaultRandom& rng) {
-         return valueGenerator<true, UniqueAppendable>(node, rng, allParsers);
+     [](Program& program, std::string_view key, const Node& node, DefaultRandom& rng) {
+         valueGenerator<true>(program, key, node, rng, allParsers);
      }},
 };
 
 
 /**
- * Used for top-level values that are of type Map.
+ * Used for values that are of type Map. Adds the instructions for the entries of the map
+ * but not for opening and closing the document itself.
  * @tparam Verbatim if we are in a `^Verbatim` block
  * @param node a "top-level"-like node e.g. `{a:1, b:{^RandomInt:{...}}`
  */
 template <bool Verbatim>
-std::unique_ptr<DocumentGenerator::Impl> documentGenerator(const Node& node, DefaultRandom& rng) {
+void documentGenerator(Program& program, const Node& node, DefaultRandom& rng) {
     if (!node.isMap()) {
         std::ostringstream stm;
         stm << "Node " << node << " must be mapping type";
@@ -471,7 +1307,8 @@ std::unique_ptr<DocumentGenerator::Impl> documentGenerator(const Node& node, Def
         auto meta = getMetaKey(node);
         if (meta) {
             if (meta == "^Verbatim") {
-                return documentGenerator<true>(node["^Verbatim"], rng);
+                documentGenerator<true>(program, node["^Verbatim"], rng);
+                return;
             }
             std::stringstream msg;
             msg << "Invalid meta-key " << *meta << " at top-level";
@@ -479,28 +1316,22 @@ std::unique_ptr<DocumentGenerator::Impl> documentGenerator(const Node& node, Def
         }
     }
 
-    DocumentGenerator::Impl::Entries entries;
     for (const auto&& [k, v] : node) {
-        auto key = k.toString();
-        auto valgen = valueGenerator<Verbatim, UniqueAppendable>(v, rng, allParsers);
-        entries.emplace_back(key, std::move(valgen));
+        valueGenerator<Verbatim>(program, k.toString(), v, rng, allParsers);
     }
-    return std::make_unique<DocumentGenerator::Impl>(std::move(entries));
 }
 
 /**
  * @tparam Verbatim if we're in a `^Verbatim block`
  * @param node sequence node
- * @return array generator that has one valueGenerator (recursive type) for each element in the node
+ * Adds the instructions for each element in the node, keyed by its index.
  */
 template <bool Verbatim>
-UniqueGenerator<bsoncxx::array::value> arrayGenerator(const Node& node, DefaultRandom& rng) {
-    ArrayGenerator::ValueType entries;
+void arrayGenerator(Program& program, const Node& node, DefaultRandom& rng) {
+    size_t index = 0;
     for (const auto&& [k, v] : node) {
-        auto valgen = valueGenerator<Verbatim, UniqueAppendable>(v, rng, allParsers);
-        entries.push_back(std::move(valgen));
+        valueGenerator<Verbatim>(program, std::to_string(index++), v, rng, allParsers);
     }
-    return std::make_unique<ArrayGenerator>(std::move(entries));
 }
 
 
@@ -533,6 +1364,10 @@ UniqueGenerator<int64_t> int64GeneratorBasedOnDistribution(const Node& node, Def
         return std::make_unique<PoissonInt64Generator>(node, rng);
     } else if (distribution == "geometric") {
         return std::make_unique<GeometricInt64Generator>(node, rng);
+    } else if (distribution == "zipfian") {
+        return std::make_unique<ZipfianInt64Generator>(node, rng);
+    } else if (distribution == "hotspot") {
+        return std::make_unique<HotspotInt64Generator>(node, rng);
     } else {
         std::stringstream error;
         error << "Unknown distribution '" << distribution << "'";
@@ -558,18 +1393,34 @@ UniqueGenerator<int64_t> intGenerator(const Node& node, DefaultRandom& rng) {
         // known parser type
         return parserPair->first(node[parserPair->second], rng);
     }
-    return std::make_unique<ConstantAppender<int64_t>>(node.to<int64_t>());
+    return std::make_unique<ConstantGenerator<int64_t>>(node.to<int64_t>());
 }
 
 }  // namespace
 
-// Kick the recursion into motion
 DocumentGenerator::DocumentGenerator(const Node& node, DefaultRandom& rng)
-    : _impl{documentGenerator<false>(node, rng)} {}
+    : DocumentGenerator{node, rng, 0} {}
+DocumentGenerator::DocumentGenerator(const Node& node, DefaultRandom& rng, ActorId id)
+    : DocumentGenerator{node, rng, id, nullptr} {}
+DocumentGenerator::DocumentGenerator(const Node& node,
+                                     DefaultRandom& rng,
+                                     ActorId id,
+                                     std::atomic<uint64_t>& incCounter)
+    : DocumentGenerator{node, rng, id, &incCounter} {}
+// Kick the recursion into motion
+DocumentGenerator::DocumentGenerator(const Node& node,
+                                     DefaultRandom& rng,
+                                     ActorId id,
+                                     std::atomic<uint64_t>* incCounter) {
+    Program program{id, incCounter};
+    documentGenerator<false>(program, node, rng);
+    program.finish();
+    _impl = std::make_unique<Impl>(std::move(program));
+}
 DocumentGenerator::DocumentGenerator(const Node& node, PhaseContext& phaseContext, ActorId id)
-    : DocumentGenerator{node, phaseContext.rng(id)} {}
+    : DocumentGenerator{node, phaseContext.rng(id), id, phaseContext.actor().incCounter(id)} {}
 DocumentGenerator::DocumentGenerator(const Node& node, ActorContext& actorContext, ActorId id)
-    : DocumentGenerator{node, actorContext.rng(id)} {}
+    : DocumentGenerator{node, actorContext.rng(id), id, actorContext.incCounter(id)} {}
 
 
 DocumentGenerator::DocumentGenerator(DocumentGenerator&&) noexcept = default;
@@ -585,4 +1436,45 @@ bsoncxx::document::value DocumentGenerator::evaluate() {
     return operator()();
 }
 
+bsoncxx::document::view DocumentGenerator::evaluateInto(DocumentBuffer& buffer) {
+    buffer._bytes.clear();
+    _impl->run(buffer._bytes);
+    return {reinterpret_cast<const uint8_t*>(buffer._bytes.data()), buffer._bytes.size()};
+}
+
+const std::vector<bsoncxx::document::view>& DocumentGenerator::generateBatch(
+    size_t n, DocumentBatch& batch) {
+    const auto before = batch._bytes.data();
+    for (size_t i = 0; i < n; ++i) {
+        _impl->run(batch._bytes);
+        batch._ends.push_back(batch._bytes.size());
+    }
+
+    // Appending may have moved the bytes, so the views are only made once they're all written.
+    // The bytes grow geometrically so usually only the new documents need views.
+    const auto data = reinterpret_cast<const uint8_t*>(batch._bytes.data());
+    if (batch._bytes.data() != before) {
+        batch._views.clear();
+    }
+    size_t start = batch._views.empty() ? 0 : batch._ends[batch._views.size() - 1];
+    for (auto i = batch._views.size(); i < batch._ends.size(); ++i) {
+        batch._views.emplace_back(data + start, batch._ends[i] - start);
+        start = batch._ends[i];
+    }
+    return batch._views;
+}
+
+DocumentPool::DocumentPool(std::vector<DocumentGenerator>& generators, size_t count)
+    : _count{count}, _width{generators.size()} {
+    if (_count == 0 || _width == 0) {
+        BOOST_THROW_EXCEPTION(
+            InvalidValueGeneratorSyntax("A DocumentPool needs at least one document"));
+    }
+    for (size_t i = 0; i < _count; ++i) {
+        for (auto& generator : generators) {
+            generator.generateBatch(1, _batch);
+        }
+    }
+}
+
 }  // namespace genny
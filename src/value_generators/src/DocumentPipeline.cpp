@@ -0,0 +1,130 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value_generators/DocumentPipeline.hpp>
+
+#include <boost/throw_exception.hpp>
+
+namespace genny {
+
+DocumentRing::DocumentRing(const std::vector<const Node*>& templates,
+                           DefaultRandom rng,
+                           ActorId id,
+                           size_t depth,
+                           std::atomic<uint64_t>* incCounter)
+    : _rng{std::move(rng)}, _slots(depth) {
+    if (templates.empty() || depth == 0) {
+        BOOST_THROW_EXCEPTION(InvalidValueGeneratorSyntax(
+            "A DocumentRing needs at least one document and one slot"));
+    }
+    _generators.reserve(templates.size());
+    for (auto node : templates) {
+        _generators.emplace_back(*node, _rng, id, incCounter ? *incCounter : _incCounter);
+    }
+}
+
+void DocumentRing::release() {
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    if (_pipeline) {
+        _pipeline->wake();
+    }
+}
+
+bool DocumentRing::fill() {
+    const auto tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == _slots.size()) {
+        return false;
+    }
+    auto& slot = _slots[tail % _slots.size()];
+    slot.clear();
+    for (auto& generator : _generators) {
+        generator.generateBatch(1, slot);
+    }
+    // Sequentially consistent with _waiting so either the Actor sees the new tail before it
+    // sleeps or this sees that it's waiting.
+    _tail.store(tail + 1);
+    if (_waiting.load()) {
+        std::lock_guard<std::mutex> lk{_lock};
+        _filled.notify_all();
+    }
+    return true;
+}
+
+void DocumentRing::waitForFill(size_t head) {
+    std::unique_lock<std::mutex> lk{_lock};
+    _waiting = true;
+    _filled.wait(lk, [&]() { return _tail.load() != head; });
+    _waiting = false;
+}
+
+DocumentPipeline::DocumentPipeline(size_t threads) {
+    if (threads == 0) {
+        BOOST_THROW_EXCEPTION(
+            InvalidValueGeneratorSyntax("A DocumentPipeline needs at least one thread"));
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : _workers) {
+        _threads.emplace_back([this, &worker]() { this->run(*worker); });
+    }
+}
+
+DocumentPipeline::~DocumentPipeline() {
+    {
+        std::lock_guard<std::mutex> lk{_lock};
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void DocumentPipeline::add(std::shared_ptr<DocumentRing> ring) {
+    ring->_pipeline = this;
+    auto& worker = *_workers[_nextWorker++ % _workers.size()];
+    {
+        std::lock_guard<std::mutex> lk{worker.lock};
+        worker.rings.push_back(std::move(ring));
+    }
+    // The worker may be asleep with nothing to fill.
+    wake();
+}
+
+void DocumentPipeline::run(Worker& worker) {
+    while (!_stopping) {
+        // Releases after this are noticed before sleeping, so none are missed.
+        const auto releases = _releases.load();
+
+        bool filled = false;
+        {
+            std::lock_guard<std::mutex> lk{worker.lock};
+            // One slot per ring at a time so every ring gets a turn.
+            for (auto& ring : worker.rings) {
+                filled = ring->fill() || filled;
+            }
+        }
+        if (filled) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk{_lock};
+        ++_sleeping;
+        _wake.wait(lk, [&]() { return _stopping || _releases.load() != releases; });
+        --_sleeping;
+    }
+}
+
+}  // namespace genny
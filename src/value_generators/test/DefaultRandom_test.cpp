@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <set>
 
 #include <boost/random/uniform_int_distribution.hpp>
 
@@ -96,6 +97,57 @@ TEST_CASE("genny DefaultRandom") {
         }
     }
 }
+
+TEST_CASE("genny DefaultRandom engines") {
+    SECTION("pcg64 matches the reference implementation") {
+        v1::Pcg64 rng{v1::Pcg64::uint128{42}, v1::Pcg64::uint128{54}};
+        REQUIRE(rng() == 0x86b1da1d72062b68ull);
+        REQUIRE(rng() == 0x1304aa46c9853d39ull);
+        REQUIRE(rng() == 0xa3670e9e0dd50358ull);
+
+        // A default-constructed pcg-cpp pcg64.
+        v1::Pcg64 defaultStream{v1::Pcg64::uint128{0xcafef00dd15ea5e5ull},
+                                v1::Pcg64::kDefaultStream};
+        REQUIRE(defaultStream() == 0xcf7dbe684e0c4045ull);
+        REQUIRE(defaultStream() == 0x15642875dfe1e67cull);
+        REQUIRE(defaultStream() == 0x32f049df2f50d811ull);
+    }
+
+    for (auto engine :
+         {RandomEngine::kMt19937_64, RandomEngine::kXoshiro256pp, RandomEngine::kPcg64}) {
+        DYNAMIC_SECTION("Engine " << static_cast<int>(engine)) {
+            DefaultRandom rng{v1::SelectableEngine{engine, 12345}};
+            DefaultRandom same{v1::SelectableEngine{engine, 12345}};
+            for (int i = 0; i < 10; ++i) {
+                REQUIRE(rng() == same());
+            }
+
+            // Splits keep the engine, so they're the same from the same start.
+            auto stream = rng.split();
+            auto sameStream = same.split();
+            REQUIRE(stream() == sameStream());
+
+            std::set<DefaultRandom::result_type> seen;
+            auto other = rng.split();
+            for (int i = 0; i < 1000; ++i) {
+                seen.insert(rng());
+                seen.insert(stream());
+                seen.insert(other());
+            }
+            REQUIRE(seen.size() == 3000);
+        }
+    }
+
+    SECTION("Engines give different values") {
+        DefaultRandom mt{v1::SelectableEngine{RandomEngine::kMt19937_64, 12345}};
+        DefaultRandom xoshiro{v1::SelectableEngine{RandomEngine::kXoshiro256pp, 12345}};
+        DefaultRandom pcg{v1::SelectableEngine{RandomEngine::kPcg64, 12345}};
+        const auto first = mt();
+        REQUIRE(first == DefaultRandom{12345}());
+        REQUIRE(first != xoshiro());
+        REQUIRE(first != pcg());
+    }
+}
 }  // namespace
 
 }  // namespace genny
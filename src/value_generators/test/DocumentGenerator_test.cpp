@@ -0,0 +1,297 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+
+#include <bsoncxx/json.hpp>
+
+#include <gennylib/Node.hpp>
+
+#include <value_generators/DefaultRandom.hpp>
+#include <value_generators/DocumentGenerator.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny {
+namespace {
+
+TEST_CASE("DocumentGenerator::evaluateInto") {
+    genny::DefaultRandom rng;
+    NodeSource ns{R"(
+        a: 1
+        b: {^RandomInt: {min: 10, max: 1000}}
+        c:
+          d: [x, {^RandomString: {length: {^RandomInt: {min: 1, max: 300}}}}]
+          e: {^FastRandomString: {length: 100}}
+        f: {g: 1.5, h: [true, null]}
+    )",
+                  ""};
+    DocumentGenerator generator{ns.root(), rng};
+
+    SECTION("Gives the same documents as evaluate") {
+        genny::DefaultRandom otherRng;
+        DocumentGenerator other{ns.root(), otherRng};
+
+        DocumentBuffer buffer;
+        for (int i = 0; i < 10; ++i) {
+            auto expected = other.evaluate();
+            auto actual = generator.evaluateInto(buffer);
+            REQUIRE(bsoncxx::to_json(actual) == bsoncxx::to_json(expected.view()));
+        }
+    }
+}
+
+TEST_CASE("DocumentGenerator::generateBatch") {
+    genny::DefaultRandom rng;
+    NodeSource ns{R"(
+        a: {^RandomInt: {min: 10, max: 1000}}
+        b: {^RandomString: {length: {^RandomInt: {min: 1, max: 300}}}}
+    )",
+                  ""};
+    DocumentGenerator generator{ns.root(), rng};
+
+    genny::DefaultRandom otherRng;
+    DocumentGenerator other{ns.root(), otherRng};
+
+    DocumentBatch batch;
+
+    SECTION("Gives the same documents as evaluate") {
+        auto& views = generator.generateBatch(100, batch);
+        REQUIRE(views.size() == 100);
+        REQUIRE(batch.size() == 100);
+
+        size_t bytes = 0;
+        for (auto&& view : views) {
+            auto expected = other.evaluate();
+            REQUIRE(bsoncxx::to_json(view) == bsoncxx::to_json(expected.view()));
+            bytes += view.length();
+        }
+        REQUIRE(batch.bytes() == bytes);
+    }
+
+    SECTION("Adds to what's already in the batch") {
+        generator.generateBatch(3, batch);
+        auto& views = generator.generateBatch(200, batch);
+        REQUIRE(views.size() == 203);
+
+        for (auto&& view : views) {
+            auto expected = other.evaluate();
+            REQUIRE(bsoncxx::to_json(view) == bsoncxx::to_json(expected.view()));
+        }
+
+        batch.clear();
+        REQUIRE(batch.size() == 0);
+        REQUIRE(batch.bytes() == 0);
+    }
+}
+
+TEST_CASE("DocumentPool") {
+    genny::DefaultRandom rng;
+    NodeSource a{"a: {^RandomInt: {min: 0, max: 1000000}}", ""};
+    NodeSource b{"b: {^RandomString: {length: 20}}", ""};
+    std::vector<DocumentGenerator> generators;
+    generators.emplace_back(a.root(), rng);
+    generators.emplace_back(b.root(), rng);
+
+    genny::DefaultRandom otherRng;
+    DocumentGenerator otherA{a.root(), otherRng};
+    DocumentGenerator otherB{b.root(), otherRng};
+
+    SECTION("Entries have one document from each generator in order") {
+        DocumentPool pool{generators, 1000};
+        REQUIRE(pool.size() == 1000);
+        REQUIRE(pool.width() == 2);
+        for (size_t i = 0; i < pool.size(); ++i) {
+            REQUIRE(bsoncxx::to_json(pool[i][0]) == bsoncxx::to_json(otherA.evaluate().view()));
+            REQUIRE(bsoncxx::to_json(pool[i][1]) == bsoncxx::to_json(otherB.evaluate().view()));
+        }
+    }
+
+    SECTION("Needs documents") {
+        REQUIRE_THROWS_AS((DocumentPool{generators, 0}), InvalidValueGeneratorSyntax);
+    }
+}
+
+/**
+ * @return how many times each value of `a` came up in `n` documents from `json`.
+ */
+std::map<int64_t, int64_t> countValues(const std::string& json, int n) {
+    NodeSource nodeSource{json, ""};
+    genny::DefaultRandom rng;
+    DocumentGenerator generator{nodeSource.root(), rng};
+    std::map<int64_t, int64_t> out;
+    for (int i = 0; i < n; ++i) {
+        ++out[generator().view()["a"].get_int64().value];
+    }
+    return out;
+}
+
+TEST_CASE("Skewed ^RandomInt distributions") {
+    SECTION("zipfian values are in range and the first is the most common") {
+        const auto counts = countValues(
+            "a: {^RandomInt: {distribution: zipfian, min: 10, max: 1009, scramble: false}}",
+            100000);
+        REQUIRE(counts.begin()->first >= 10);
+        REQUIRE(counts.rbegin()->first <= 1009);
+        // 1/H(1000, 0.99) is about 0.129 and 2^-0.99 of that is about 0.065.
+        REQUIRE(counts.at(10) > 12000);
+        REQUIRE(counts.at(10) < 14000);
+        REQUIRE(counts.at(11) > 6000);
+        REQUIRE(counts.at(11) < 7000);
+    }
+
+    SECTION("zipfian scrambling moves the popular values but keeps them in range") {
+        const auto counts = countValues(
+            "a: {^RandomInt: {distribution: zipfian, min: 10, max: 1009, s: 1.2}}", 100000);
+        REQUIRE(counts.begin()->first >= 10);
+        REQUIRE(counts.rbegin()->first <= 1009);
+        const auto top = std::max_element(counts.begin(),
+                                          counts.end(),
+                                          [](auto&& l, auto&& r) { return l.second < r.second; });
+        REQUIRE(top->second > 10000);
+    }
+
+    SECTION("zipfian works over every int64") {
+        REQUIRE(countValues("a: {^RandomInt: {distribution: zipfian, "
+                            "min: -9223372036854775808, max: 9223372036854775807}}",
+                            1000)
+                    .size() > 1);
+    }
+
+    SECTION("hotspot gives the hot keys their fraction of the values") {
+        const auto counts = countValues("a: {^RandomInt: {distribution: hotspot, min: 0, max: 99, "
+                                        "hotFraction: 0.2, hotOpFraction: 0.8, scramble: false}}",
+                                        100000);
+        REQUIRE(counts.begin()->first >= 0);
+        REQUIRE(counts.rbegin()->first <= 99);
+        int64_t hot = 0;
+        for (const auto& [value, count] : counts) {
+            if (value < 20) {
+                hot += count;
+            }
+        }
+        REQUIRE(hot > 79000);
+        REQUIRE(hot < 81000);
+    }
+
+    SECTION("hotspot with everything hot is uniform") {
+        REQUIRE(countValues("a: {^RandomInt: {distribution: hotspot, min: 0, max: 9, "
+                            "hotFraction: 1, hotOpFraction: 0.5}}",
+                            1000)
+                    .size() == 10);
+    }
+}
+
+TEST_CASE("^Inc") {
+    NodeSource nodeSource{"a: {^Inc: {start: 100, multiplier: 1000, step: 2}}", ""};
+    genny::DefaultRandom rng;
+
+    SECTION("Each Actor starts at its own multiple") {
+        DocumentGenerator first{nodeSource.root(), rng, 0};
+        DocumentGenerator second{nodeSource.root(), rng, 3};
+        for (int64_t i = 0; i < 10; ++i) {
+            REQUIRE(first().view()["a"].get_int64().value == 100 + 2 * i);
+            REQUIRE(second().view()["a"].get_int64().value == 3100 + 2 * i);
+        }
+    }
+
+    SECTION("Generators for the same Actor share a counter") {
+        NodeSource other{"b: {^Inc: {start: 100, multiplier: 1000, step: 2}}", ""};
+        std::atomic<uint64_t> counter{0};
+        DocumentGenerator first{nodeSource.root(), rng, 3, counter};
+        DocumentGenerator second{other.root(), rng, 3, counter};
+        for (int64_t i = 0; i < 10; i += 2) {
+            REQUIRE(first().view()["a"].get_int64().value == 3100 + 2 * i);
+            REQUIRE(second().view()["b"].get_int64().value == 3100 + 2 * (i + 1));
+        }
+        REQUIRE(counter == 10);
+
+        // E.g. a later Phase's generator carries on from where the others got to.
+        DocumentGenerator third{nodeSource.root(), rng, 3, counter};
+        REQUIRE(third().view()["a"].get_int64().value == 3100 + 2 * 10);
+    }
+
+    SECTION("Actors get 2^32 values each by default") {
+        NodeSource defaults{"a: {^Inc: {}}", ""};
+        DocumentGenerator generator{defaults.root(), rng, 2};
+        REQUIRE(generator().view()["a"].get_int64().value == int64_t{2} << 32);
+        REQUIRE(generator().view()["a"].get_int64().value == (int64_t{2} << 32) + 1);
+    }
+}
+
+TEST_CASE("^ObjectId") {
+    NodeSource nodeSource{"a: {^ObjectId: {}}", ""};
+    genny::DefaultRandom rng;
+    DocumentGenerator first{nodeSource.root(), rng};
+    DocumentGenerator second{nodeSource.root(), rng};
+
+    std::set<std::string> seen;
+    for (int i = 0; i < 1000; ++i) {
+        for (auto* generator : {&first, &second}) {
+            const auto doc = (*generator)();
+            const auto element = doc.view()["a"];
+            REQUIRE(element.type() == bsoncxx::type::k_oid);
+            seen.insert(element.get_oid().value.to_string());
+        }
+    }
+    // Generators don't share anything but still never give the same id.
+    REQUIRE(seen.size() == 2000);
+}
+
+TEST_CASE("Values copied from a shared slab") {
+    genny::DefaultRandom rng;
+
+    SECTION("^RandomBinary gives generic binary of the given length") {
+        NodeSource nodeSource{"a: {^RandomBinary: {length: 1000}}", ""};
+        DocumentGenerator generator{nodeSource.root(), rng};
+        const auto first = generator();
+        const auto second = generator();
+        const auto a = first.view()["a"].get_binary();
+        const auto b = second.view()["a"].get_binary();
+        REQUIRE(a.sub_type == bsoncxx::binary_sub_type::k_binary);
+        REQUIRE(a.size == 1000);
+        REQUIRE(b.size == 1000);
+        // Different places in the slab.
+        REQUIRE(std::memcmp(a.bytes, b.bytes, a.size) != 0);
+    }
+
+    SECTION("^RandomSlabString only uses the default alphabet") {
+        NodeSource nodeSource{"a: {^RandomSlabString: {length: {^RandomInt: {min: 0, max: 100}}}}",
+                              ""};
+        DocumentGenerator generator{nodeSource.root(), rng};
+        for (int i = 0; i < 100; ++i) {
+            const auto doc = generator();
+            const auto str = doc.view()["a"].get_utf8().value;
+            REQUIRE(str.size() <= 100);
+            REQUIRE(std::all_of(str.begin(), str.end(), [](char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '/';
+            }));
+        }
+    }
+
+    SECTION("Values can be longer than the slab") {
+        NodeSource nodeSource{"a: {^RandomSlabString: {length: 20000000}}", ""};
+        DocumentGenerator generator{nodeSource.root(), rng};
+        REQUIRE(generator().view()["a"].get_utf8().value.size() == 20000000);
+    }
+}
+
+}  // namespace
+}  // namespace genny
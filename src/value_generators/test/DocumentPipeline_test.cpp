@@ -0,0 +1,130 @@
+// Copyright 2019-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <thread>
+
+#include <boost/fiber/fiber.hpp>
+
+#include <bsoncxx/json.hpp>
+
+#include <gennylib/Node.hpp>
+
+#include <value_generators/DefaultRandom.hpp>
+#include <value_generators/DocumentPipeline.hpp>
+
+#include <testlib/helpers.hpp>
+
+namespace genny {
+namespace {
+
+TEST_CASE("DocumentPipeline") {
+    NodeSource a{"a: {^RandomInt: {min: 0, max: 1000000}}", ""};
+    NodeSource b{"b: {^RandomString: {length: {^RandomInt: {min: 1, max: 500}}}}", ""};
+    const std::vector<const Node*> templates{&a.root(), &b.root()};
+
+    // What the ring should give, generated on this thread.
+    DefaultRandom expectedRng{1234};
+    DocumentGenerator expectedA{a.root(), expectedRng};
+    DocumentGenerator expectedB{b.root(), expectedRng};
+
+    SECTION("Rings get documents in the order they're generated") {
+        auto ring = std::make_shared<DocumentRing>(templates, DefaultRandom{1234}, 0, 4);
+        REQUIRE(ring->depth() == 4);
+        {
+            DocumentPipeline pipeline{1};
+            pipeline.add(ring);
+
+            for (int i = 0; i < 1000; ++i) {
+                const auto& batch = ring->acquire();
+                REQUIRE(batch.size() == 2);
+                REQUIRE(bsoncxx::to_json(batch.views()[0]) ==
+                        bsoncxx::to_json(expectedA.evaluate().view()));
+                REQUIRE(bsoncxx::to_json(batch.views()[1]) ==
+                        bsoncxx::to_json(expectedB.evaluate().view()));
+                REQUIRE(ring->ready() <= ring->depth());
+                ring->release();
+            }
+        }
+        // The pipeline's gone but the ring is still ours.
+        REQUIRE(ring->ready() <= ring->depth());
+    }
+
+    SECTION("Rings fill up while nobody takes from them") {
+        auto ring = std::make_shared<DocumentRing>(templates, DefaultRandom{1234}, 0, 8);
+        DocumentPipeline pipeline{1};
+        pipeline.add(ring);
+        while (ring->ready() < ring->depth()) {
+            std::this_thread::yield();
+        }
+        REQUIRE(ring->ready() == 8);
+        ring->acquire();
+        ring->release();
+        REQUIRE(ring->ready() >= 7);
+    }
+
+    SECTION("Waiting for a slot lets other fibers on the thread run") {
+        auto ring = std::make_shared<DocumentRing>(templates, DefaultRandom{1234}, 0, 2);
+        DocumentPipeline pipeline{1};
+
+        // The consumer runs first and finds the ring empty until the other fiber adds it.
+        bool added = false;
+        bool addedBeforeAcquired = false;
+        boost::fibers::fiber consumer{[&]() {
+            ring->acquire();
+            addedBeforeAcquired = added;
+            ring->release();
+        }};
+        boost::fibers::fiber adder{[&]() {
+            added = true;
+            pipeline.add(ring);
+        }};
+        consumer.join();
+        adder.join();
+        REQUIRE(addedBeforeAcquired);
+    }
+
+    SECTION("Threads each fill some of the rings") {
+        DocumentPipeline pipeline{3};
+        std::vector<std::shared_ptr<DocumentRing>> rings;
+        for (int i = 0; i < 8; ++i) {
+            rings.push_back(std::make_shared<DocumentRing>(templates, DefaultRandom(i), i, 2));
+            pipeline.add(rings.back());
+        }
+
+        // One consumer per ring like one Actor thread per ring.
+        std::vector<std::thread> consumers;
+        std::vector<int64_t> counts(rings.size());
+        for (size_t i = 0; i < rings.size(); ++i) {
+            consumers.emplace_back([&, i]() {
+                for (int j = 0; j < 500; ++j) {
+                    counts[i] += rings[i]->acquire().size();
+                    rings[i]->release();
+                }
+            });
+        }
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+        REQUIRE(counts == std::vector<int64_t>(rings.size(), 1000));
+    }
+
+    SECTION("Rings need documents and slots") {
+        REQUIRE_THROWS_AS(DocumentRing({}, DefaultRandom{}, 0, 4), InvalidValueGeneratorSyntax);
+        REQUIRE_THROWS_AS(DocumentRing(templates, DefaultRandom{}, 0, 0),
+                          InvalidValueGeneratorSyntax);
+    }
+}
+
+}  // namespace
+}  // namespace genny